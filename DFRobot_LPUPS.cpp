@@ -11,6 +11,12 @@
  */
 #include "DFRobot_LPUPS.h"
 
+// Every transaction has to be bounded (LPUPS_I2C_TIMEOUT_US): poll timing, max_poll_us
+// and the retry backoff rely on it, so there is no fallback to an unbounded Wire
+#if !defined(WIRE_HAS_TIMEOUT)
+#error "Wire timeout support required (Arduino AVR core >= 1.8.3)"
+#endif
+
 DFRobot_LPUPS::DFRobot_LPUPS()
 {
 }
@@ -38,10 +44,14 @@ int DFRobot_LPUPS::begin(uint16_t upsType)
 
 /***************** Config function ******************************/
 
-void DFRobot_LPUPS::getChipData(uint8_t* regBuf)
+bool DFRobot_LPUPS::getChipData(CS32RegisterMap& regs)
 {
-  readReg(CS32_I2C_CHARGER_STATUS_REG, regBuf, CS32_I2C_SET_VBAT_LIMIT_REG + 2);
-  delay(20);
+  return sizeof(regs) == readReg(CS32_I2C_CHARGER_STATUS_REG, &regs, sizeof(regs));
+}
+
+bool DFRobot_LPUPS::getVbusData(CS32RegisterMap& regs)
+{
+  return sizeof(regs.adcVbus) == readReg(CS32_I2C_ADC_VBUS_REG, &regs.adcVbus, sizeof(regs.adcVbus));
 }
 
 void DFRobot_LPUPS::setMaxChargeVoltage(uint16_t data)
@@ -76,9 +86,48 @@ DFRobot_LPUPS_I2C::DFRobot_LPUPS_I2C(TwoWire* pWire, uint8_t i2cAddr)
 int DFRobot_LPUPS_I2C::begin(uint16_t upsType)
 {
   _pWire->begin();   // Wire.h(I2C)library function initialize wire library
+  _pWire->setWireTimeout(LPUPS_I2C_TIMEOUT_US, true);   // Bound every transaction, reset TWI on timeout
   return DFRobot_LPUPS::begin(upsType);   // Use the initialization function of the parent class
 }
 
+bool DFRobot_LPUPS_I2C::recoverBus()
+{
+  _pWire->end();   // Hand SDA/SCL back to the port logic
+
+  // Open-drain emulation: drive LOW as output, release as input with pull-up
+  pinMode(SDA, INPUT_PULLUP);
+  pinMode(SCL, INPUT_PULLUP);
+  delayMicroseconds(5);
+
+  // A slave stuck mid-byte releases SDA after at most 9 clocks
+  for (uint8_t i = 0; (i < 9) && (LOW == digitalRead(SDA)); i++) {
+    digitalWrite(SCL, LOW);
+    pinMode(SCL, OUTPUT);
+    delayMicroseconds(5);
+    pinMode(SCL, INPUT_PULLUP);
+    delayMicroseconds(5);
+  }
+
+  // STOP condition: SDA rises while SCL is high. SCL goes low first, so pulling
+  // SDA low is not seen as a START
+  digitalWrite(SCL, LOW);
+  pinMode(SCL, OUTPUT);
+  delayMicroseconds(5);
+  digitalWrite(SDA, LOW);
+  pinMode(SDA, OUTPUT);
+  delayMicroseconds(5);
+  pinMode(SCL, INPUT_PULLUP);
+  delayMicroseconds(5);
+  pinMode(SDA, INPUT_PULLUP);
+  delayMicroseconds(5);
+  bool released = (HIGH == digitalRead(SDA));
+
+  _pWire->begin();
+  _pWire->setWireTimeout(LPUPS_I2C_TIMEOUT_US, true);
+  DBG(released ? "bus recovered" : "bus still held");
+  return released;
+}
+
 void DFRobot_LPUPS_I2C::writeReg(uint8_t reg, const void* pBuf, size_t size)
 {
   if (pBuf == NULL) {
@@ -105,15 +154,20 @@ size_t DFRobot_LPUPS_I2C::readReg(uint8_t reg, void* pBuf, size_t size)
 
   _pWire->beginTransmission(_deviceAddr);
   _pWire->write(reg);
-  if (0 != _pWire->endTransmission()) {   // Used Wire.endTransmission() to end a slave transmission started by beginTransmission() and arranged by write().
+  if (0 != _pWire->endTransmission()) {   // Used Wire.endTransmission() to end a slave transmission started by beginTransmission() and arranged by write(). Returns 5 on timeout.
     DBG("endTransmission ERROR!!");
   } else {
     _pWire->requestFrom(_deviceAddr, (uint8_t)size);   // Master device requests size bytes from slave device, which can be accepted by master device with read() or available()
 
-    while (_pWire->available()) {
+    while (_pWire->available() && (count < size)) {
       _pBuf[count++] = _pWire->read();   // Use read() to receive and put into buf
     }
     // _pWire->endTransmission();
   }
+  if (_pWire->getWireTimeoutFlag()) {   // A timed out transfer may have returned partial data
+    _pWire->clearWireTimeoutFlag();
+    DBG("I2C timeout");
+    return 0;
+  }
   return count;
 }
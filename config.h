@@ -26,6 +26,8 @@
 
 #define MIN_UPDATE_INTERVAL         120     // Minimum update interval for USB-HID
 #define MIN_SERIAL_REPORT_INTERVAL  5000    // Minimum interval for serial output
+#define INPUT_DEBOUNCE_MS           5       // Minimum time between accepted edges on one input
+#define IDLE_MAX_SLEEP_MS           500     // Longest idle sleep before loop() runs again (below the 1 s watchdog timeout)
 
 // ============================================================================
 // Feature Enable Flags
@@ -38,6 +40,16 @@
 // Feature enable flags
 #define ENABLE_MOUSE_KEYBOARD 1
 #define ENABLE_HID_POWER_DEVICE 1
+#define ENABLE_PERF_GOVERNOR 1      // Battery-aware sampling/report/LED rates
+#define ENABLE_IDLE_SLEEP 1         // Sleep while the gamepad enable switch is off
+#define ENABLE_SERIAL_CONSOLE 1     // Live tuning commands on Serial (see console.h)
+#define ENABLE_INPUT_TRACE 0        // Stream per-frame input traces over Serial (see tools/trace_replay.cpp)
+#define ENABLE_HIRES_MOUSE 1        // 16-bit mouse deltas and hi-res wheel (see hires_mouse.h)
+#define ENABLE_NKRO_KEYBOARD 1      // Bitmap keyboard report, sent once per frame (see nkro_keyboard.h)
+#define ENABLE_WATCHDOG 1           // Hang recovery with warm restart state (see watchdog.h)
+#define ENABLE_CYCLE_PROFILE 0      // Timer1 cycle counts per loop stage and ISR (see cycle_profile.h)
+#define ENABLE_PERSIST_STORE 1      // Calibration and battery estimate kept in EEPROM (see persist_store.h)
+#define ENABLE_FACE_BUTTONS 0       // PIN_BTN_* are not wired yet (PIN_BTN_R2 shares pin 4 with PIN_GAMEPAD_ENABLE, rejected at compile time)
 
 // ============================================================================
 // Memory Configuration
@@ -46,6 +58,7 @@
 #define DATA_LEN_MAX                0x24U
 #define OUTPUT_BUFFER_SIZE          128     // Reduced to save memory
 #define DEBUG_BUFFER_SIZE           64      // Reduced to save memory
+#define INPUT_EVENT_QUEUE_SIZE      16      // Captured button edges (power of two)
 
 // ============================================================================
 // Action Assignments
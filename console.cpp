@@ -0,0 +1,252 @@
+#include "console.h"
+#include "input_events.h"
+#include "input_map.h"
+#include "macros.h"
+#include "idle_mode.h"
+#include "perf_governor.h"
+#include "ups_simple.h"
+#include "cycle_profile.h"
+#include "turbo.h"
+#include "persist_store.h"
+#include <stdlib.h>
+
+// ============================================================================
+// Debug Streams
+// ============================================================================
+
+DebugStream gamepadDebug(tunables.debugGamepad);
+DebugStream upsDebug(tunables.debugUps);
+
+// ============================================================================
+// Tunable Registry
+// ============================================================================
+
+struct TunableDef {
+    const char* name;               // PROGMEM string
+    uint16_t* value;
+    uint16_t minValue;
+    uint16_t maxValue;
+};
+
+static const char tnMouseSensitivity[] PROGMEM = "mouse_sensitivity";
+static const char tnSideMax[] PROGMEM = "side_max";
+static const char tnBinaryThreshold[] PROGMEM = "binary_threshold";
+static const char tnSprintThreshold[] PROGMEM = "sprint_threshold";
+static const char tnUpsPollMs[] PROGMEM = "ups_poll_ms";
+static const char tnDebugGamepad[] PROGMEM = "debug_gamepad";
+static const char tnDebugUps[] PROGMEM = "debug_ups";
+static const char tnTurboHz[] PROGMEM = "turbo_hz";
+
+static const TunableDef tunableTable[] PROGMEM = {
+    { tnMouseSensitivity,  &tunables.mouseSensitivity,  PERF_MIN_MOUSE_SENSITIVITY, 30000 },
+    { tnSideMax,           &tunables.sideMax,           50,  511 },
+    { tnBinaryThreshold,   &tunables.binaryThreshold,   1,   511 },
+    { tnSprintThreshold,   &tunables.sprintThreshold,   21,  720 },
+    { tnUpsPollMs,         &tunables.upsPollMs,         0,   60000 },
+    { tnDebugGamepad,      &tunables.debugGamepad,      0,   1 },
+    { tnDebugUps,          &tunables.debugUps,          0,   1 },
+    { tnTurboHz,           &tunables.turboRateHz,       1,   TURBO_RATE_MAX_HZ },
+};
+
+#define TUNABLE_COUNT               (sizeof(tunableTable) / sizeof(tunableTable[0]))
+
+// ============================================================================
+// Console State
+// ============================================================================
+
+static char lineBuf[CONSOLE_LINE_MAX + 1];
+static uint8_t lineLen = 0;
+static bool lineOverflow = false;       // Discard input until the end of an overlong line
+
+// ============================================================================
+// Replies
+// ============================================================================
+
+static void printError(const __FlashStringHelper* message) {
+    Serial.print(F("{\"console\":{\"error\":\""));
+    Serial.print(message);
+    Serial.println(F("\"}}"));
+}
+
+static void printTunable(uint8_t index) {
+    TunableDef def;
+    memcpy_P(&def, &tunableTable[index], sizeof(def));
+    Serial.print(F("{\"tunable\":{\"name\":\""));
+    Serial.print((const __FlashStringHelper*)def.name);
+    Serial.print(F("\",\"value\":"));
+    Serial.print(*def.value);
+    Serial.print(F(",\"min\":"));
+    Serial.print(def.minValue);
+    Serial.print(F(",\"max\":"));
+    Serial.print(def.maxValue);
+    Serial.println(F("}}"));
+}
+
+// Gap between the heap (or static data) and the stack
+static int freeRam() {
+    extern char __heap_start, *__brkval;
+    char top;
+    return (int)(&top - (__brkval ? __brkval : &__heap_start));
+}
+
+static void printStats() {
+    const IdleStats& idle = getIdleStats();
+    Serial.print(F("{\"stats\":{\"uptime_ms\":"));
+    Serial.print(millis());
+    Serial.print(F(",\"input_dropped\":"));
+    Serial.print(getInputEventsDropped());
+    Serial.print(F(",\"layer\":"));
+    Serial.print(getActiveLayer());
+    Serial.print(F(",\"macro_playing\":"));
+    Serial.print(isMacroPlaying() ? F("true") : F("false"));
+    Serial.print(F(",\"turbo_toggles\":"));
+    Serial.print(getTurboToggles());
+    Serial.print(F(",\"profile\":\""));
+    Serial.print(getPerfProfileName(getActivePerfProfileId()));
+    Serial.print(F("\",\"idle_wakeups\":"));
+    Serial.print(idle.wakeups);
+    Serial.print(F(",\"idle_ms\":"));
+    Serial.print(idle.idleMs);
+    Serial.print(F(",\"max_wake_to_report_us\":"));
+    Serial.print(idle.maxWakeToReportUs);
+    #if ENABLE_HID_POWER_DEVICE
+    Serial.print(F(",\"ups_poll_us\":"));
+    Serial.print(simple_ups.getLastPollMicros());
+    Serial.print(F(",\"ups_max_poll_us\":"));
+    Serial.print(simple_ups.getMaxPollMicros());
+    Serial.print(F(",\"ups_interval_ms\":"));
+    Serial.print(simple_ups.getPollIntervalMs());
+    Serial.print(F(",\"ups_polls\":"));
+    Serial.print(simple_ups.getPollCount());
+    Serial.print(F(",\"ups_vbus_polls\":"));
+    Serial.print(simple_ups.getVbusPollCount());
+    #endif
+    #if ENABLE_PERSIST_STORE
+    Serial.print(F(",\"persist_records\":"));
+    Serial.print(getPersistRecordCount());
+    #endif
+    Serial.print(F(",\"free_ram\":"));
+    Serial.print(freeRam());
+    Serial.println(F("}}"));
+}
+
+// ============================================================================
+// Command Handling
+// ============================================================================
+
+static int8_t findTunable(const char* name) {
+    for (uint8_t i = 0; i < TUNABLE_COUNT; i++) {
+        if (strcmp_P(name, (const char*)pgm_read_ptr(&tunableTable[i].name)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Split off the next space-separated token (in place)
+static char* nextToken(char*& cursor) {
+    while (*cursor == ' ') cursor++;
+    if (!*cursor) {
+        return nullptr;
+    }
+    char* token = cursor;
+    while (*cursor && *cursor != ' ') cursor++;
+    if (*cursor) {
+        *cursor++ = '\0';
+    }
+    return token;
+}
+
+static void setTunable(const char* name, const char* valueText) {
+    int8_t index = findTunable(name);
+    if (index < 0) {
+        printError(F("unknown tunable"));
+        return;
+    }
+
+    char* end;
+    unsigned long value = strtoul(valueText, &end, 0);
+    TunableDef def;
+    memcpy_P(&def, &tunableTable[index], sizeof(def));
+    if (*end != '\0' || end == valueText || value < def.minValue || value > def.maxValue) {
+        printError(F("value out of range"));
+        return;
+    }
+
+    *def.value = (uint16_t)value;
+    printTunable(index);
+}
+
+static void runCommand(char* line) {
+    char* cursor = line;
+    char* command = nextToken(cursor);
+    if (!command) {
+        return;
+    }
+    char* arg1 = nextToken(cursor);
+    char* arg2 = nextToken(cursor);
+
+    if (strcmp_P(command, PSTR("list")) == 0) {
+        for (uint8_t i = 0; i < TUNABLE_COUNT; i++) {
+            printTunable(i);
+        }
+    } else if (strcmp_P(command, PSTR("get")) == 0 && arg1) {
+        int8_t index = findTunable(arg1);
+        if (index < 0) {
+            printError(F("unknown tunable"));
+        } else {
+            printTunable(index);
+        }
+    } else if (strcmp_P(command, PSTR("set")) == 0 && arg1 && arg2) {
+        setTunable(arg1, arg2);
+    } else if (strcmp_P(command, PSTR("stats")) == 0) {
+        printStats();
+    } else if (strcmp_P(command, PSTR("status")) == 0) {
+        #if ENABLE_HID_POWER_DEVICE
+        simple_ups.reportBatteryStatus();
+        simple_ups.reportPowerStatus();
+        #else
+        printError(F("ups disabled"));
+        #endif
+    } else if (strcmp_P(command, PSTR("perf")) == 0) {
+        #if ENABLE_CYCLE_PROFILE
+        reportCycleProfile();
+        #else
+        printError(F("profiler disabled"));
+        #endif
+    } else if (strcmp_P(command, PSTR("help")) == 0) {
+        Serial.println(F("{\"console\":{\"commands\":\"list, get <name>, set <name> <value>, stats, status, perf, help\"}}"));
+    } else {
+        printError(F("unknown command"));
+    }
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void loopConsole() {
+    // Bounded amount of work per call, even while a host is flooding the port
+    for (uint8_t i = 0; i < CONSOLE_BYTES_PER_LOOP && Serial.available() > 0; i++) {
+        char c = (char)Serial.read();
+
+        if (c == '\n' || c == '\r') {
+            if (lineOverflow) {
+                printError(F("line too long"));
+            } else if (lineLen > 0) {
+                lineBuf[lineLen] = '\0';
+                runCommand(lineBuf);
+            }
+            lineLen = 0;
+            lineOverflow = false;
+        } else if (lineLen < CONSOLE_LINE_MAX) {
+            lineBuf[lineLen++] = c;
+        } else {
+            lineOverflow = true;
+        }
+    }
+}
+
+bool isConsoleInputPending() {
+    return Serial.available() > 0;
+}
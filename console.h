@@ -0,0 +1,54 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "tunables.h"
+
+// ============================================================================
+// Serial Console
+// ============================================================================
+// Line-oriented commands on Serial for live tuning. Input is collected in a
+// fixed buffer a few bytes per loop; nothing is allocated and the loop is
+// never blocked waiting for input. Replies are JSON lines.
+//
+//   list                  All tunables with value and range
+//   get <name>            One tunable
+//   set <name> <value>    Change a tunable (range checked)
+//   stats                 Timing and event counters
+//   status                UPS status report and power model
+//   perf                  Cycle profile of the current window (ENABLE_CYCLE_PROFILE)
+//   help                  Command list
+
+#define CONSOLE_LINE_MAX            40      // Longest accepted command line
+#define CONSOLE_BYTES_PER_LOOP      16      // Input bytes consumed per loopConsole() call
+
+// ============================================================================
+// Debug Output
+// ============================================================================
+// DEBUG_PRINT_* decide at compile time whether debug output exists; these
+// streams let the console mute it at runtime (debug_gamepad / debug_ups).
+
+class DebugStream : public Print {
+public:
+    explicit DebugStream(const uint16_t& enabled) : enabled(enabled) {}
+    size_t write(uint8_t c) override { return enabled ? Serial.write(c) : 1; }
+
+private:
+    const uint16_t& enabled;
+};
+
+extern DebugStream gamepadDebug;
+extern DebugStream upsDebug;
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Read pending input and run complete commands (call every loop)
+void loopConsole();
+
+// True when unread console input is waiting (ends idle sleep early)
+bool isConsoleInputPending();
+
+#endif // CONSOLE_H
@@ -0,0 +1,173 @@
+#ifndef CS32_REGISTERS_H
+#define CS32_REGISTERS_H
+
+#include <Arduino.h>
+#include <stddef.h>
+
+// ============================================================================
+// CS32 Register Map (DFRobot LPUPS)
+// ============================================================================
+// The UPS exposes the charger registers as one block starting at address 0x00.
+// CS32RegisterMap mirrors that block byte for byte, so the I2C receive buffer
+// is the struct itself: no copies and no per-byte index constants elsewhere.
+// Multi-byte registers are little endian, like the AVR.
+
+// Register addresses
+#define CS32_I2C_CHARGER_STATUS_REG   0x00U   // 21/20h
+#define CS32_I2C_PROCHOT_STATUS_REG   0x02U   // 23/22h
+
+#define CS32_I2C_ADC_PSYS_REG         0x06U   // 26h, PSYS: Full range: 3.06 V, LSB 12 mV
+#define CS32_I2C_ADC_VBUS_REG         0x07U   // 27h, VBUS: Full range: 3.2 V - 19.52 V, LSB 64 mV
+#define CS32_I2C_ADC_IDCHG_REG        0x08U   // 28h, IDCHG: Full range: 32.512 A, LSB 256 mA
+#define CS32_I2C_ADC_ICHG_REG         0x09U   // 29h, ICHG: Full range: 8.128 A, LSB 64 mA
+#define CS32_I2C_ADC_CMPIN_REG        0x0AU   // 2Ah, CMPIN: Full range: 3.06 V, LSB 12 mV
+#define CS32_I2C_ADC_IIN_REG          0x0BU   // 2Bh, POR status - IIN: Full range: 12.75 A, LSB 50 mA
+#define CS32_I2C_ADC_VBAT_REG         0x0CU   // 2Ch, VBAT: Full range: 2.88 V - 19.2 V, LSB 64 mV
+#define CS32_I2C_ADC_VSYS_REG         0x0DU   // 2Dh, VSYS: Full range: 2.88 V - 19.2 V, LSB 64 mV
+
+#define CS32_I2C_PID_REG              0x10U
+#define CS32_I2C_VID_REG              0x12U
+#define CS32_I2C_VERSION_REG          0x14U
+
+#define CS32_I2C_SET_VBAT_LIMIT_REG   0x16U
+
+#define CS32_REGISTER_BLOCK_SIZE      (CS32_I2C_SET_VBAT_LIMIT_REG + 2)
+
+// ADC scaling
+#define CS32_PSYS_LSB_mV              12
+#define CS32_VBUS_OFFSET_mV           3200
+#define CS32_VBUS_LSB_mV              64
+#define CS32_IDCHG_LSB_mA             256
+#define CS32_ICHG_LSB_mA              64
+#define CS32_CMPIN_LSB_mV             12
+#define CS32_IIN_LSB_mA               50
+#define CS32_VBAT_OFFSET_mV           2880    // VBAT raw 0 reads as 2.88 V = no battery
+#define CS32_VBAT_LSB_mV              64
+#define CS32_VSYS_OFFSET_mV           2880
+#define CS32_VSYS_LSB_mV              64
+#define CS32_CURRENT_RAW_MASK         0x7F    // ICHG/IDCHG are 7-bit ADC values
+
+// Fault bits of charger status 0 (20h); latched by the chip until read
+#define CS32_FAULT_OTG_UVP            (1 << 0)
+#define CS32_FAULT_OTG_OVP            (1 << 1)
+#define CS32_FAULT_LATCHOFF           (1 << 2)
+#define CS32_FAULT_SYS_SHORT          (1 << 3)
+#define CS32_FAULT_SYSOVP             (1 << 4)
+#define CS32_FAULT_ACOC               (1 << 5)
+#define CS32_FAULT_BATOC              (1 << 6)
+#define CS32_FAULT_ACOV               (1 << 7)
+#define CS32_FAULT_COUNT              8
+
+// ============================================================================
+// Status Registers
+// ============================================================================
+
+// Charger status 0 (20h): faults
+struct sChargerStatus0_t {
+    uint8_t f_otg_uvp: 1;       // OTG undervoltage
+    uint8_t f_otg_ovp: 1;       // OTG overvoltage
+    uint8_t f_latchoff: 1;      // Latch off (REG0x30[3])
+    uint8_t f_sys_short: 1;     // SYS below 2.4 V after 7 restart tries (latched until cleared)
+    uint8_t sysovp_stat: 1;     // In SYSOVP, converter disabled until cleared
+    uint8_t f_acoc: 1;          // Input overcurrent
+    uint8_t f_batoc: 1;         // Battery overcurrent
+    uint8_t f_acov: 1;          // Input overvoltage
+} __attribute__((packed));
+
+// Charger status 1 (21h): operating state
+struct sChargerStatus1_t {
+    uint8_t in_otg: 1;          // In OTG
+    uint8_t in_pchrg: 1;        // In pre-charge
+    uint8_t in_fchrg: 1;        // In fast charge
+    uint8_t in_iindpm: 1;       // In input current regulation
+    uint8_t in_vindpm: 1;       // In input voltage regulation (OTG: voltage regulation)
+    uint8_t in_vap: 1;          // Operating in VAP mode
+    uint8_t ico_done: 1;        // Input current optimizer complete
+    uint8_t ac_stat: 1;         // Input source present (same as CHRG_OK)
+} __attribute__((packed));
+
+// PROCHOT status 0 (22h): triggered profiles
+struct sProchotStatus0_t {
+    uint8_t s_adapter_removal: 1;
+    uint8_t s_battery_removal: 1;
+    uint8_t s_vsys: 1;
+    uint8_t s_idchg: 1;
+    uint8_t s_inom: 1;
+    uint8_t s_icrit: 1;
+    uint8_t s_comp: 1;
+    uint8_t s_vdpm: 1;
+} __attribute__((packed));
+
+// PROCHOT status 1 (23h)
+struct sProchotStatus1_t {
+    uint8_t stat_exit_vap: 1;   // PROCHOT_EXIT_VAP active until cleared
+    uint8_t stat_vap_fail: 1;   // VBUS load failed 7 times in VAP mode
+    uint8_t reserved1: 1;
+    uint8_t prochot_clear: 1;   // 0 = clear the PROCHOT pulse
+    uint8_t prochot_width: 2;   // 100 us, 1 ms, 10 ms, 5 s
+    uint8_t en_prochot_exit: 1; // Pulse extension enabled
+    uint8_t reserved: 1;
+} __attribute__((packed));
+
+// ============================================================================
+// Register Block
+// ============================================================================
+
+struct CS32RegisterMap {
+    sChargerStatus0_t chargerStatus0;   // 0x00
+    sChargerStatus1_t chargerStatus1;   // 0x01
+    sProchotStatus0_t prochotStatus0;   // 0x02
+    sProchotStatus1_t prochotStatus1;   // 0x03
+    uint8_t reserved04[2];              // 0x04
+    uint8_t adcPsys;                    // 0x06
+    uint8_t adcVbus;                    // 0x07
+    uint8_t adcIdchg;                   // 0x08
+    uint8_t adcIchg;                    // 0x09
+    uint8_t adcCmpin;                   // 0x0A
+    uint8_t adcIin;                     // 0x0B
+    uint8_t adcVbat;                    // 0x0C
+    uint8_t adcVsys;                    // 0x0D
+    uint8_t reserved0E[2];              // 0x0E
+    uint16_t pid;                       // 0x10
+    uint16_t vid;                       // 0x12
+    uint16_t version;                   // 0x14
+    uint16_t vbatLimit_mV;              // 0x16
+
+    // ADC channels in physical units
+    uint16_t psys_mV() const  { return (uint16_t)adcPsys * CS32_PSYS_LSB_mV; }
+    uint16_t vbus_mV() const  { return CS32_VBUS_OFFSET_mV + (uint16_t)adcVbus * CS32_VBUS_LSB_mV; }
+    uint16_t idchg_mA() const { return (uint16_t)(adcIdchg & CS32_CURRENT_RAW_MASK) * CS32_IDCHG_LSB_mA; }
+    uint16_t ichg_mA() const  { return (uint16_t)(adcIchg & CS32_CURRENT_RAW_MASK) * CS32_ICHG_LSB_mA; }
+    uint16_t cmpin_mV() const { return (uint16_t)adcCmpin * CS32_CMPIN_LSB_mV; }
+    uint16_t iin_mA() const   { return (uint16_t)adcIin * CS32_IIN_LSB_mA; }
+    uint16_t vbat_mV() const  { return CS32_VBAT_OFFSET_mV + (uint16_t)adcVbat * CS32_VBAT_LSB_mV; }
+    uint16_t vsys_mV() const  { return CS32_VSYS_OFFSET_mV + (uint16_t)adcVsys * CS32_VSYS_LSB_mV; }
+
+    // VBAT raw 0 means the ADC has not measured a battery
+    bool hasBattery() const { return adcVbat != 0; }
+    bool inputPresent() const { return chargerStatus1.ac_stat; }
+
+    // Charger status 0 as CS32_FAULT_* bits
+    uint8_t faultFlags() const { return *reinterpret_cast<const uint8_t*>(&chargerStatus0); }
+} __attribute__((packed));
+
+static_assert(sizeof(sChargerStatus0_t) == 1 && sizeof(sChargerStatus1_t) == 1 &&
+              sizeof(sProchotStatus0_t) == 1 && sizeof(sProchotStatus1_t) == 1,
+              "Status registers are one byte each");
+static_assert(sizeof(CS32RegisterMap) == CS32_REGISTER_BLOCK_SIZE, "Register map must match the chip data block");
+static_assert(offsetof(CS32RegisterMap, chargerStatus0) == CS32_I2C_CHARGER_STATUS_REG, "Charger status offset");
+static_assert(offsetof(CS32RegisterMap, prochotStatus0) == CS32_I2C_PROCHOT_STATUS_REG, "PROCHOT status offset");
+static_assert(offsetof(CS32RegisterMap, adcPsys) == CS32_I2C_ADC_PSYS_REG, "PSYS offset");
+static_assert(offsetof(CS32RegisterMap, adcVbus) == CS32_I2C_ADC_VBUS_REG, "VBUS offset");
+static_assert(offsetof(CS32RegisterMap, adcIdchg) == CS32_I2C_ADC_IDCHG_REG, "IDCHG offset");
+static_assert(offsetof(CS32RegisterMap, adcIchg) == CS32_I2C_ADC_ICHG_REG, "ICHG offset");
+static_assert(offsetof(CS32RegisterMap, adcCmpin) == CS32_I2C_ADC_CMPIN_REG, "CMPIN offset");
+static_assert(offsetof(CS32RegisterMap, adcIin) == CS32_I2C_ADC_IIN_REG, "IIN offset");
+static_assert(offsetof(CS32RegisterMap, adcVbat) == CS32_I2C_ADC_VBAT_REG, "VBAT offset");
+static_assert(offsetof(CS32RegisterMap, adcVsys) == CS32_I2C_ADC_VSYS_REG, "VSYS offset");
+static_assert(offsetof(CS32RegisterMap, pid) == CS32_I2C_PID_REG, "PID offset");
+static_assert(offsetof(CS32RegisterMap, vid) == CS32_I2C_VID_REG, "VID offset");
+static_assert(offsetof(CS32RegisterMap, version) == CS32_I2C_VERSION_REG, "Version offset");
+static_assert(offsetof(CS32RegisterMap, vbatLimit_mV) == CS32_I2C_SET_VBAT_LIMIT_REG, "VBAT limit offset");
+
+#endif // CS32_REGISTERS_H
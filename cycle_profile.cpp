@@ -0,0 +1,136 @@
+#include "cycle_profile.h"
+#include <util/atomic.h>
+
+#if ENABLE_CYCLE_PROFILE
+
+// ============================================================================
+// Profiler State
+// ============================================================================
+
+static volatile uint16_t cycleHigh = 0;         // Timer1 overflows
+static ProfileStats profileStats[PROF_SLOT_COUNT];
+static uint16_t measureOverhead = 0;            // Cycles of an empty BEGIN/END pair
+static uint32_t windowStartMs = 0;
+
+static const char slotLoopGamepad[] PROGMEM = "loop_gamepad";
+static const char slotFrameAxes[] PROGMEM = "frame_axes";
+static const char slotFrameKeys[] PROGMEM = "frame_keys";
+static const char slotFrameEmit[] PROGMEM = "frame_emit";
+static const char slotUpsUpdate[] PROGMEM = "ups_update";
+static const char slotIsrInputTick[] PROGMEM = "isr_input_tick";
+static const char slotIsrPcint[] PROGMEM = "isr_pcint";
+static const char slotIsrLed[] PROGMEM = "isr_led";
+
+static const char* const slotNames[PROF_SLOT_COUNT] PROGMEM = {
+    slotLoopGamepad, slotFrameAxes, slotFrameKeys, slotFrameEmit,
+    slotUpsUpdate, slotIsrInputTick, slotIsrPcint, slotIsrLed
+};
+
+ISR(TIMER1_OVF_vect) {
+    cycleHigh++;
+}
+
+static void resetWindow() {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        for (uint8_t i = 0; i < PROF_SLOT_COUNT; i++) {
+            profileStats[i].count = 0;
+            profileStats[i].totalCycles = 0;
+            profileStats[i].minCycles = 0xFFFFFFFFUL;
+            profileStats[i].maxCycles = 0;
+        }
+    }
+    windowStartMs = millis();
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void setupCycleProfile() {
+    // Timer1 free-running at clk/1, overflow extends it to 32 bits
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    TCCR1C = 0;
+    TCNT1 = 0;
+    TIMSK1 = _BV(TOIE1);
+
+    // Calibrate the cost of the measurement itself
+    uint16_t overhead = 0xFFFF;
+    for (uint8_t i = 0; i < 8; i++) {
+        uint32_t start = readCycleCounter();
+        uint32_t cycles = readCycleCounter() - start;
+        if (cycles < overhead) {
+            overhead = (uint16_t)cycles;
+        }
+    }
+    measureOverhead = overhead;
+
+    resetWindow();
+}
+
+uint32_t readCycleCounter() {
+    uint16_t low;
+    uint16_t high;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        low = TCNT1;
+        high = cycleHigh;
+        // Overflow happened but its interrupt is still pending
+        if ((TIFR1 & _BV(TOV1)) && low < 0x8000) {
+            high++;
+        }
+    }
+    return ((uint32_t)high << 16) | low;
+}
+
+void recordCycles(uint8_t slot, uint32_t cycles) {
+    cycles = cycles > measureOverhead ? cycles - measureOverhead : 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ProfileStats& stats = profileStats[slot];
+        stats.count++;
+        stats.totalCycles += cycles;
+        if (cycles < stats.minCycles) stats.minCycles = cycles;
+        if (cycles > stats.maxCycles) stats.maxCycles = cycles;
+    }
+}
+
+void loopCycleProfile() {
+    #if CYCLE_PROFILE_REPORT_MS > 0
+    if (millis() - windowStartMs >= CYCLE_PROFILE_REPORT_MS) {
+        reportCycleProfile();
+    }
+    #endif
+}
+
+void reportCycleProfile() {
+    ProfileStats snapshot[PROF_SLOT_COUNT];
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        memcpy(snapshot, profileStats, sizeof(snapshot));
+    }
+    uint32_t windowMs = millis() - windowStartMs;
+    resetWindow();
+
+    // JSON status report, same framing as the UPS report
+    Serial.print(F("{\"perf\":{\"f_cpu\":"));
+    Serial.print(F_CPU);
+    Serial.print(F(",\"window_ms\":"));
+    Serial.print(windowMs);
+    Serial.print(F(",\"overhead\":"));
+    Serial.print(measureOverhead);
+    for (uint8_t i = 0; i < PROF_SLOT_COUNT; i++) {
+        const ProfileStats& stats = snapshot[i];
+        Serial.print(F(",\""));
+        Serial.print((const __FlashStringHelper*)pgm_read_ptr(&slotNames[i]));
+        Serial.print(F("\":{\"n\":"));
+        Serial.print(stats.count);
+        Serial.print(F(",\"min\":"));
+        Serial.print(stats.count ? stats.minCycles : 0);
+        Serial.print(F(",\"avg\":"));
+        Serial.print(stats.count ? stats.totalCycles / stats.count : 0);
+        Serial.print(F(",\"max\":"));
+        Serial.print(stats.maxCycles);
+        Serial.print('}');
+    }
+    Serial.println(F("}}"));
+}
+
+#endif // ENABLE_CYCLE_PROFILE
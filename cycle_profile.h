@@ -0,0 +1,71 @@
+#ifndef CYCLE_PROFILE_H
+#define CYCLE_PROFILE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ============================================================================
+// Cycle Profiler
+// ============================================================================
+// Counts CPU cycles of the main loop stages and the ISRs on the target itself.
+// Timer1 runs at clk/1 and is extended to 32 bits by its overflow interrupt,
+// so every count is in exact CPU cycles and includes float emulation, PROGMEM
+// reads and everything else the host replay cannot see. The measuring overhead
+// is calibrated at start and subtracted. ISR counts cover the ISR body, not the
+// compiler-generated prologue/epilogue.
+//
+// Results are printed as one JSON line per window (see docs/architecture.md),
+// so captures from two firmware revisions can be diffed directly.
+
+#define CYCLE_PROFILE_REPORT_MS     10000   // Report and restart the window (0 = console "perf" only)
+
+enum ProfileSlot : uint8_t {
+    PROF_LOOP_GAMEPAD = 0,          // loopGamepad()
+    PROF_FRAME_AXES,                // computeFrameAxes() (inside loop_gamepad)
+    PROF_FRAME_KEYS,                // computeFrameKeys()
+    PROF_FRAME_EMIT,                // emitFrame(): HID reports of the frame
+    PROF_UPS_UPDATE,                // SimpleUPS::update()
+    PROF_ISR_INPUT_TICK,            // TIMER0_COMPA: input scan and key pulses
+    PROF_ISR_PCINT,                 // PCINT0: button edges on port B
+    PROF_ISR_LED,                   // TIMER3_COMPB: LED pattern step
+    PROF_SLOT_COUNT
+};
+
+struct ProfileStats {
+    uint32_t count;
+    uint32_t totalCycles;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+};
+
+// ============================================================================
+// Instrumentation Macros
+// ============================================================================
+
+#if ENABLE_CYCLE_PROFILE
+#define PROFILE_BEGIN(slot)         uint32_t profileStart_##slot = readCycleCounter()
+#define PROFILE_END(slot)           recordCycles(slot, readCycleCounter() - profileStart_##slot)
+#else
+#define PROFILE_BEGIN(slot)
+#define PROFILE_END(slot)
+#endif
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+void setupCycleProfile();
+
+// Cycles since setupCycleProfile(), wraps after 2^32 (268 s at 16 MHz)
+uint32_t readCycleCounter();
+
+// Add one measurement to a slot (safe from ISRs and the main loop)
+void recordCycles(uint8_t slot, uint32_t cycles);
+
+// Periodic report (call every loop)
+void loopCycleProfile();
+
+// JSON report of the current window, then start a new one
+void reportCycleProfile();
+
+#endif // CYCLE_PROFILE_H
@@ -0,0 +1,167 @@
+#ifndef FAST_PIN_H
+#define FAST_PIN_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// Fast Pin Access
+// ============================================================================
+// FastPin<PIN> resolves an Arduino pin number to its port and bit at compile
+// time. With the AVR policy every access is a constant I/O register and mask,
+// so read() compiles to SBIS/SBIC and high()/low() to SBI/CBI, with no lookup
+// tables, no pointer and no interrupt masking (digitalRead/digitalWrite take
+// ~50 cycles each). An unmapped pin fails to compile.
+//
+// The register policy is a template parameter: AvrPort on the target, MockPort
+// on host builds, where each port is three plain bytes a test can inspect and
+// drive.
+//
+// pinsDistinct() compares the physical port/bit of a list of pins, so a wiring
+// table can reject two functions on one pin with a static_assert.
+
+// Port identifiers (high nibble of a pin code)
+#define FAST_PIN_PORT_B             1
+#define FAST_PIN_PORT_C             2
+#define FAST_PIN_PORT_D             3
+#define FAST_PIN_PORT_E             4
+#define FAST_PIN_PORT_F             5
+
+#define FAST_PIN_CODE(port, bit)    (uint8_t)(((port) << 4) | (bit))
+#define FAST_PIN_NONE               0
+
+// ============================================================================
+// Pin Table (Arduino Leonardo / ATmega32U4, same order as pins_arduino.h)
+// ============================================================================
+
+constexpr uint8_t fastPinTable[] = {
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 2),  // D0  RX
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 3),  // D1  TX
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 1),  // D2  SDA
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 0),  // D3  SCL
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 4),  // D4
+    FAST_PIN_CODE(FAST_PIN_PORT_C, 6),  // D5
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 7),  // D6
+    FAST_PIN_CODE(FAST_PIN_PORT_E, 6),  // D7
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 4),  // D8
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 5),  // D9
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 6),  // D10
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 7),  // D11
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 6),  // D12
+    FAST_PIN_CODE(FAST_PIN_PORT_C, 7),  // D13 LED
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 3),  // D14 MISO
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 1),  // D15 SCK
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 2),  // D16 MOSI
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 0),  // D17 SS / RX LED
+    FAST_PIN_CODE(FAST_PIN_PORT_F, 7),  // D18 A0
+    FAST_PIN_CODE(FAST_PIN_PORT_F, 6),  // D19 A1
+    FAST_PIN_CODE(FAST_PIN_PORT_F, 5),  // D20 A2
+    FAST_PIN_CODE(FAST_PIN_PORT_F, 4),  // D21 A3
+    FAST_PIN_CODE(FAST_PIN_PORT_F, 1),  // D22 A4
+    FAST_PIN_CODE(FAST_PIN_PORT_F, 0),  // D23 A5
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 4),  // D24 A6 (= D4)
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 7),  // D25 A7 (= D6)
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 4),  // D26 A8 (= D8)
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 5),  // D27 A9 (= D9)
+    FAST_PIN_CODE(FAST_PIN_PORT_B, 6),  // D28 A10 (= D10)
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 6),  // D29 A11 (= D12)
+    FAST_PIN_CODE(FAST_PIN_PORT_D, 5),  // D30 TX LED
+};
+
+constexpr uint8_t fastPinCode(uint8_t pin) {
+    return pin < sizeof(fastPinTable) ? fastPinTable[pin] : FAST_PIN_NONE;
+}
+
+// ============================================================================
+// Conflict Check
+// ============================================================================
+
+constexpr bool pinNotIn(uint8_t) {
+    return true;
+}
+
+template <typename... Rest>
+constexpr bool pinNotIn(uint8_t pin, uint8_t first, Rest... rest) {
+    return fastPinCode(pin) != fastPinCode(first) && pinNotIn(pin, rest...);
+}
+
+constexpr bool pinsDistinct() {
+    return true;
+}
+
+// True when no two pins share a port bit (A6..A11 alias their digital pins)
+template <typename... Rest>
+constexpr bool pinsDistinct(uint8_t first, Rest... rest) {
+    return pinNotIn(first, rest...) && pinsDistinct(rest...);
+}
+
+// ============================================================================
+// Register Policies
+// ============================================================================
+
+// Target: the port's PINx/PORTx/DDRx, all in the SBI/CBI/SBIS address range
+#if defined(PINB)
+template <uint8_t Port> struct AvrPort;
+
+#define FAST_PIN_AVR_PORT(id, letter)                                           \
+    template <> struct AvrPort<id> {                                            \
+        static volatile uint8_t& in()   { return PIN##letter; }                 \
+        static volatile uint8_t& out()  { return PORT##letter; }                \
+        static volatile uint8_t& ddr()  { return DDR##letter; }                 \
+        static void toggle(uint8_t mask) { PIN##letter = mask; }                \
+    };
+
+FAST_PIN_AVR_PORT(FAST_PIN_PORT_B, B)
+FAST_PIN_AVR_PORT(FAST_PIN_PORT_C, C)
+FAST_PIN_AVR_PORT(FAST_PIN_PORT_D, D)
+FAST_PIN_AVR_PORT(FAST_PIN_PORT_E, E)
+FAST_PIN_AVR_PORT(FAST_PIN_PORT_F, F)
+
+#undef FAST_PIN_AVR_PORT
+#endif // PINB
+
+// Host: plain bytes per port; tests set inReg to simulate pin levels
+template <uint8_t Port>
+struct MockPort {
+    static volatile uint8_t inReg;
+    static volatile uint8_t outReg;
+    static volatile uint8_t ddrReg;
+
+    static volatile uint8_t& in()   { return inReg; }
+    static volatile uint8_t& out()  { return outReg; }
+    static volatile uint8_t& ddr()  { return ddrReg; }
+    static void toggle(uint8_t mask) { outReg ^= mask; }
+};
+
+template <uint8_t Port> volatile uint8_t MockPort<Port>::inReg = 0;
+template <uint8_t Port> volatile uint8_t MockPort<Port>::outReg = 0;
+template <uint8_t Port> volatile uint8_t MockPort<Port>::ddrReg = 0;
+
+#if defined(__AVR__)
+#define FAST_PIN_DEFAULT_PORT       AvrPort
+#else
+#define FAST_PIN_DEFAULT_PORT       MockPort
+#endif
+
+// ============================================================================
+// FastPin
+// ============================================================================
+
+template <uint8_t Pin, template <uint8_t> class PortPolicy = FAST_PIN_DEFAULT_PORT>
+struct FastPin {
+    static_assert(fastPinCode(Pin) != FAST_PIN_NONE, "Pin has no port mapping on this board");
+
+    typedef PortPolicy<(fastPinCode(Pin) >> 4)> Port;
+    static const uint8_t mask = (uint8_t)(1 << (fastPinCode(Pin) & 0x0F));
+
+    static void input()       { Port::ddr() &= ~mask; Port::out() &= ~mask; }
+    static void inputPullup() { Port::ddr() &= ~mask; Port::out() |= mask; }
+    static void output()      { Port::ddr() |= mask; }
+
+    static bool read()        { return (Port::in() & mask) != 0; }
+    static void high()        { Port::out() |= mask; }
+    static void low()         { Port::out() &= ~mask; }
+    static void write(bool level) { if (level) high(); else low(); }
+    static void toggle()      { Port::toggle(mask); }
+};
+
+#endif // FAST_PIN_H
@@ -3,38 +3,69 @@
 #include "config.h"
 #include "gamepad_pinout.h"
 #include "gamepad_assignment.h"
+#include "input_events.h"
+#include "idle_mode.h"
+#include "perf_governor.h"
+#include "input_trace.h"
+#include "macros.h"
+#include "input_map.h"
+#include "key_pulse.h"
+#include "tunables.h"
+#include "console.h"
+#include "watchdog.h"
+#include "nkro_keyboard.h"
+#include "persist_store.h"
 #include <stdarg.h>
 
+// ============================================================================
+// Pin Assignment Check
+// ============================================================================
+
+static_assert(pinsDistinct(PIN_GAMEPAD_ENABLE,
+                           PIN_JOYSTICK_L_X, PIN_JOYSTICK_L_Y, PIN_JOYSTICK_L_SEL,
+                           PIN_JOYSTICK_R_X, PIN_JOYSTICK_R_Y, PIN_JOYSTICK_R_SEL,
+#if ENABLE_FACE_BUTTONS
+                           PIN_BTN_L1, PIN_BTN_L2, PIN_BTN_L3, PIN_BTN_L4,
+                           PIN_BTN_R1, PIN_BTN_R2, PIN_BTN_R3, PIN_BTN_R4,
+#endif
+                           UPS_STATUS_LED, SDA, SCL),
+              "Two functions share a pin (see gamepad_pinout.h)");
+
 // ============================================================================
 // Global Variables
 // ============================================================================
 
-// Joystick data structures
+// Joystick pins and calibration
 JoystickData leftJoystick;
 JoystickData rightJoystick;
 
+// Frame sent last and frame being built
+GamepadFrameBuffer gamepadFrames;
 
 // Gamepad state
 bool gamepadDisabled = false;
-bool sprintActive = false;
+
+// Sampling/report schedule (rates come from the active performance profile)
+uint32_t lastSampleUs = 0;
+uint32_t lastReportUs = 0;
 
 void printGamepad(const char* msg){
   #if DEBUG_PRINT_GAMEPAD
-  Serial.print("Gamepad: ");
-  Serial.println(msg);
+  gamepadDebug.print("Gamepad: ");
+  gamepadDebug.println(msg);
   #endif
 }
 
 void printGamepad(const String& msg){
   #if DEBUG_PRINT_GAMEPAD
-  Serial.print("Gamepad: ");
-  Serial.println(msg);
+  gamepadDebug.print("Gamepad: ");
+  gamepadDebug.println(msg);
   #endif
 }
 
 void printGamepadF(const char* format, ...){
   #if DEBUG_PRINT_GAMEPAD
-  Serial.print("Gamepad: ");
+  gamepadDebug.print("Gamepad: ");
   
   // Create a buffer for the formatted string
   char buffer[128];
@@ -43,57 +74,174 @@ void printGamepadF(const char* format, ...){
   vsnprintf(buffer, sizeof(buffer), format, args);
   va_end(args);
   
-  Serial.println(buffer);
+  gamepadDebug.println(buffer);
   #endif
 }
 
+#if ENABLE_PERSIST_STORE
+// A reading close to the stored zero confirms it; a stick that drifted or is
+// deflected at power-up needs the settle delay and a fresh calibration
+static bool nearZero(int reading, int stored)
+{
+  return abs(reading - stored) <= JOYSTICK_ZERO_TOLERANCE;
+}
+
+// Cold start: skip the settle delay when every axis reads near its stored zero
+static bool restoreStoredCalibration(JoystickData& left, JoystickData& right)
+{
+  PersistCalibration stored;
+  if (!persistRestore(PERSIST_KEY_CALIBRATION, &stored, sizeof(stored))) {
+    return false;
+  }
+  calibrateJoystick(left);
+  calibrateJoystick(right);
+  return nearZero(left.xZero, stored.joystickZero[0]) &&
+         nearZero(left.yZero, stored.joystickZero[1]) &&
+         nearZero(right.xZero, stored.joystickZero[2]) &&
+         nearZero(right.yZero, stored.joystickZero[3]);
+}
+
+static void saveStoredCalibration(const JoystickData& left, const JoystickData& right)
+{
+  PersistCalibration cal = {{ (int16_t)left.xZero, (int16_t)left.yZero,
+                              (int16_t)right.xZero, (int16_t)right.yZero }};
+  persistSave(PERSIST_KEY_CALIBRATION, &cal, sizeof(cal));
+}
+#endif
+
+// Press buttons that were already held when the gamepad got enabled
+static void syncHeldInputs()
+{
+  InputEvent event;
+  event.timestampUs = micros();
+  for (uint8_t source = 0; source < INPUT_SRC_COUNT; source++) {
+    if (isInputPressed(source)) {
+      event.source = source;
+      event.pressed = true;
+      mapInputEvent(event);
+    }
+  }
+}
+
 void setupGamepad()
 {
-  pinMode(PIN_GAMEPAD_ENABLE, INPUT_PULLUP);
+  GamepadEnablePin::inputPullup();
   
   // Initialize joysticks
   initializeJoystick(leftJoystick, PIN_JOYSTICK_L_X, PIN_JOYSTICK_L_Y, PIN_JOYSTICK_L_SEL);
   initializeJoystick(rightJoystick, PIN_JOYSTICK_R_X, PIN_JOYSTICK_R_Y, PIN_JOYSTICK_R_SEL);
 
-  delay(1000); // Wait a second to allow the joysticks to stabilize
-  
-  // Calibrate joysticks
-  calibrateJoystick(leftJoystick);
-  calibrateJoystick(rightJoystick);
+  // After a warm restart the sticks are already settled and calibrated
+  #if ENABLE_WATCHDOG
+  bool calibrated = restoreWarmCalibration(leftJoystick, rightJoystick);
+  #else
+  bool calibrated = false;
+  #endif
+
+  #if ENABLE_PERSIST_STORE
+  if (!calibrated) {
+    calibrated = restoreStoredCalibration(leftJoystick, rightJoystick);
+    #if ENABLE_WATCHDOG
+    if (calibrated) {
+      saveWarmCalibration(leftJoystick, rightJoystick);
+    }
+    #endif
+  }
+  #endif
+
+  if (!calibrated) {
+    delay(1000); // Wait a second to allow the joysticks to stabilize
+    
+    // Calibrate joysticks
+    calibrateJoystick(leftJoystick);
+    calibrateJoystick(rightJoystick);
+
+    #if ENABLE_WATCHDOG
+    saveWarmCalibration(leftJoystick, rightJoystick);
+    #endif
+  }
+
+  // Written in the background, and only if the zeros changed
+  #if ENABLE_PERSIST_STORE
+  saveStoredCalibration(leftJoystick, rightJoystick);
+  #endif
+
+  // Start interrupt-driven button capture
+  setupInputEvents();
+  setupInputMap();
+
+  #if ENABLE_INPUT_TRACE
+  startInputTrace();
+  #endif
 
   Serial.println("Gamepad ready");
 }
 
 void loopGamepad()
 {
-  if (!digitalRead(PIN_GAMEPAD_ENABLE)) 
+  if (!GamepadEnablePin::read())
   {
+    InputEvent event;
+    bool justEnabled = gamepadDisabled;
+
     if(gamepadDisabled){
       Serial.println("Gamepad enabled");
+      // Edges seen while disabled are stale, the current levels are what counts
+      while (popInputEvent(event)) {}
+      syncHeldInputs();
     }
     gamepadDisabled = false;
 
-    // Read and process joystick values
-    readJoystick(leftJoystick, JOYSTICK_L_INVERT_X, JOYSTICK_L_INVERT_Y);
-    readJoystick(rightJoystick, JOYSTICK_R_INVERT_X, JOYSTICK_R_INVERT_Y);
-    
-    // Process axis movements for directional keys
-    processAxisMovement(leftJoystick, JOYSTICK_BINARY_THRESHOLD);
+    const PerfProfile& profile = getActivePerfProfile();
+    uint32_t nowUs = micros();
+
+    // Read joystick values at the profile's ADC rate
+    if (justEnabled || (nowUs - lastSampleUs >= profile.adcSampleIntervalUs)) {
+      lastSampleUs = nowUs;
+      sampleJoysticks(leftJoystick, rightJoystick, gamepadFrames.next());
+    }
     
-    // Handle mouse movement (right joystick)
-    processMouseMovement(rightJoystick, JOYSTICK_MOUSE_SENSITIVITY);
+    // Handle button edges in the order they were captured
+    while (popInputEvent(event)) {
+      mapInputEvent(event);
+    }
+    loopInputMap(micros());
     
-    // Handle joystick button presses
-    handleButtonPress(PIN_JOYSTICK_R_SEL, rightJoystick.selFlag, MOUSE_LEFT, "right joystick button");
-    handleButtonPress(PIN_JOYSTICK_L_SEL, leftJoystick.selFlag, ACTION_JOYSTICK_L_PRESS, "left joystick button");
+    // Advance macro playback (never blocks joystick processing)
+    loopMacros(millis());
     
-    // Handle directional keys (left joystick)
-    handleDirectionalKeys(leftJoystick, ACTION_JOYSTICK_L_UP, ACTION_JOYSTICK_L_DOWN, 
-                         ACTION_JOYSTICK_L_LEFT, ACTION_JOYSTICK_L_RIGHT, JOYSTICK_BINARY_THRESHOLD);
+    #if KEY_PWM_ENABLED
+    // Forward movement key pulses generated in the input tick
+    applyKeyPulses();
+    #endif
     
-    // Handle sprint key
-    if (SPRINT_THRESHOLD_ENABLED) {
-      handleSprintKey(leftJoystick, ACTION_JOYSTICK_L_MAX, SPRINT_THRESHOLD, sprintActive);
+    // Send movement at the profile's HID report rate
+    if (justEnabled || (nowUs - lastReportUs >= profile.hidReportIntervalUs)) {
+      lastReportUs = nowUs;
+
+      // Mouse sensitivity is scaled so cursor speed does not depend on the report rate
+      int sensitivity = scaleMouseSensitivity(tunables.mouseSensitivity, profile.hidReportIntervalUs,
+                                              PERF_BASE_REPORT_INTERVAL_US);
+      GamepadFrame& frame = gamepadFrames.next();
+      frame.timestampUs = nowUs;
+      frame.inputs = getInputLevels();
+      processJoystickFrame(gamepadFrames.previous(), frame, leftJoystick, rightJoystick, sensitivity);
+
+      // Turbo edges land on report frames
+      applyTurbo();
+
+      #if ENABLE_INPUT_TRACE
+      traceInputFrame(frame, leftJoystick, rightJoystick, profile.hidReportIntervalUs);
+      #endif
+      gamepadFrames.commit();
+    }
+
+    // All key changes of this pass (events, macros, pulses, sticks) in one report
+    flushGamepadKeyboard();
+
+    // First report after leaving idle sleep
+    if (justEnabled) {
+      reportWakeLatency();
     }
 
     // Debug output
@@ -102,32 +250,43 @@ void loopGamepad()
     unsigned long currentMillis = millis();
     if (currentMillis - lastPrint >= 500) {
       lastPrint = currentMillis;
+      const GamepadFrame& frame = gamepadFrames.previous();
       char buf[DEBUG_BUFFER_SIZE];
       snprintf(buf, sizeof(buf),
            "R Joy Y:%6d | R Joy X:%6d | L Joy Y:%6d | L Joy X:%6d",
-           rightJoystick.yValue, rightJoystick.xValue, leftJoystick.yValue, leftJoystick.xValue);
-      Serial.println(buf);
+           frame.axis[FRAME_AXIS_RY], frame.axis[FRAME_AXIS_RX],
+           frame.axis[FRAME_AXIS_LY], frame.axis[FRAME_AXIS_LX]);
+      gamepadDebug.println(buf);
+      if (getInputEventsDropped() > 0) {
+        printGamepadF("Input events dropped: %u", getInputEventsDropped());
+      }
     }
     #endif
 
   } else {
     if (!gamepadDisabled){
       // Release all keys and mouse buttons when gamepad is disabled
+      resetInputMap();
       releaseAllMouseButtons();
       releaseAllKeys();
       
-      // Reset joystick states
-      leftJoystick.yPosPressed = false;
-      leftJoystick.yNegPressed = false;
-      leftJoystick.xPosPressed = false;
-      leftJoystick.xNegPressed = false;
-      leftJoystick.selFlag = 0;
-      rightJoystick.selFlag = 0;
-      sprintActive = false;
+      // The stick keys were released above; start again from an empty frame
+      gamepadFrames.reset();
+      flushGamepadKeyboard();
       
       gamepadDisabled = true;
       Serial.println("Gamepad disabled");
     }
+    // Keep the event queue from filling up while disabled
+    InputEvent event;
+    while (popInputEvent(event)) {}
+    #if !ENABLE_IDLE_SLEEP
     delay(1);
+    #endif
   }
 }
+
+bool isGamepadDisabled()
+{
+  return gamepadDisabled;
+}
@@ -12,6 +12,7 @@
 
 void setupGamepad();
 void loopGamepad();
+bool isGamepadDisabled();
 void printGamepad(const char* msg);
 void printGamepad(const String& msg);
 void printGamepadF(const char* format, ...);
@@ -29,6 +29,22 @@
 #define JOYSTICK_X_DEADZONE         10      // Deadzone for X-axis to prevent drift
 #define JOYSTICK_Y_DEADZONE         10      // Deadzone for Y-axis to prevent drift
 #define JOYSTICK_BINARY_THRESHOLD   200     // Threshold for binary joystick movement
+#define JOYSTICK_ZERO_TOLERANCE     24      // Cold start skips the settle delay when all axes read this close
+
+// Proportional movement keys (instead of the binary threshold)
+#define KEY_PWM_ENABLED             0       // Pulse left joystick keys with duty proportional to deflection
+#define KEY_PWM_PERIOD_MS           50      // Pulse period (1.024 ms input ticks, max 255)
+#define KEY_PWM_MIN_DEFLECTION      50      // Below this the key stays released
+#define KEY_PWM_FULL_DEFLECTION     400     // From this on the key stays pressed
+
+// Scroll mode (right joystick scrolls while a button bound to ACTION_SCROLL is held)
+#define SCROLL_MAX_DETENTS_PER_S    20      // Wheel detents per second at full deflection
+#define SCROLL_DEADZONE             40      // Below this the stick does not scroll
+#define SCROLL_MAX_STEP_US          100000  // Longest frame gap credited to the scroll accumulator
+
+// Turbo (ACTION_TURBO): press/release pairs per second, runtime tunable "turbo_hz"
+#define TURBO_RATE_HZ               10
+#define TURBO_RATE_MAX_HZ           50      // Each half period must span at least one report frame
 
 // ============================================================================
 // Special Action Definitions
@@ -37,6 +53,39 @@
 // Define for buttons/actions that should have no effect
 #define ACTION_NONE                    0
 
+// Button actions (stick clicks and face buttons) carry their type in the high
+// byte. Joystick direction actions below stay plain ASCII characters.
+#define ACTION_TYPE_KEY                0x01        // ASCII character, e.g. ACTION_KEY('f')
+#define ACTION_TYPE_KEYCODE            0x02        // Raw HID keycode, e.g. ACTION_KEYCODE(KEY_LEFT_SHIFT)
+#define ACTION_TYPE_MOUSE              0x03        // Mouse button, e.g. ACTION_MOUSE(MOUSE_LEFT)
+#define ACTION_TYPE_MACRO              0x04        // MacroId from macros.h
+#define ACTION_TYPE_LAYER              0x05        // Switch to a layer while held
+#define ACTION_TYPE_TRANSPARENT        0x06        // Use the base layer action
+#define ACTION_TYPE_SCROLL             0x07        // Right joystick scrolls while held
+
+#define ACTION_KEY(c)                  ((ACTION_TYPE_KEY << 8) | (uint8_t)(c))
+#define ACTION_KEYCODE(k)              ((ACTION_TYPE_KEYCODE << 8) | (uint8_t)(k))
+#define ACTION_MOUSE(b)                ((ACTION_TYPE_MOUSE << 8) | (uint8_t)(b))
+#define ACTION_MACRO(id)               ((ACTION_TYPE_MACRO << 8) | (uint8_t)(id))
+#define ACTION_LAYER(n)                ((ACTION_TYPE_LAYER << 8) | (uint8_t)(n))
+#define ACTION_TRANSPARENT             (ACTION_TYPE_TRANSPARENT << 8)
+#define ACTION_SCROLL                  (ACTION_TYPE_SCROLL << 8)
+
+// Auto-fire a key, keycode or mouse action at TURBO_RATE_HZ while the button is
+// held, e.g. ACTION_TURBO(ACTION_MOUSE(MOUSE_LEFT)). Not supported for chords.
+#define ACTION_FLAG_TURBO              0x8000
+#define ACTION_TURBO(a)                ((a) | ACTION_FLAG_TURBO)
+#define ACTION_TYPE(a)                 (((a) >> 8) & 0x7F)
+
+// Layers
+#define LAYER_BASE                     0
+#define LAYER_ALT                      1           // Active while a button bound to ACTION_LAYER(LAYER_ALT) is held
+#define LAYER_COUNT                    2
+
+// Chords: buttons pressed together within this window trigger the chord action
+// instead of their own. Only buttons that are part of a chord are delayed.
+#define CHORD_WINDOW_MS                30
+
 // ============================================================================
 // Left Joystick Actions
 // ============================================================================
@@ -46,7 +95,7 @@
 #define ACTION_JOYSTICK_L_DOWN         's'
 #define ACTION_JOYSTICK_L_LEFT         'a'
 #define ACTION_JOYSTICK_L_RIGHT        'd'
-#define ACTION_JOYSTICK_L_PRESS        ' '         // Space character
+#define ACTION_JOYSTICK_L_PRESS        ACTION_KEY(' ')     // Space character
 #define ACTION_JOYSTICK_L_MAX          'e'         // Sprint when moving joystick beyond threshold
 
 // ============================================================================
@@ -54,10 +103,10 @@
 // ============================================================================
 // Left side buttons (L1-L4)
 
-#define ACTION_BTN_L1                  MOUSE_RIGHT
-#define ACTION_BTN_L2                  KEY_Q       // Top button
-#define ACTION_BTN_L3                  KEY_1       // Middle button
-#define ACTION_BTN_L4                  KEY_2       // Bottom button
+#define ACTION_BTN_L1                  ACTION_MOUSE(MOUSE_RIGHT)
+#define ACTION_BTN_L2                  ACTION_KEYCODE(KEY_Q)       // Top button
+#define ACTION_BTN_L3                  ACTION_KEYCODE(KEY_1)       // Middle button
+#define ACTION_BTN_L4                  ACTION_KEYCODE(KEY_2)       // Bottom button
 
 // ============================================================================
 // Right Joystick Actions
@@ -68,7 +117,7 @@
 #define ACTION_JOYSTICK_R_DOWN         MOUSE_MOVE_DOWN
 #define ACTION_JOYSTICK_R_LEFT         MOUSE_MOVE_LEFT
 #define ACTION_JOYSTICK_R_RIGHT        MOUSE_MOVE_RIGHT
-#define ACTION_JOYSTICK_R_PRESS        MOUSE_LEFT
+#define ACTION_JOYSTICK_R_PRESS        ACTION_MOUSE(MOUSE_LEFT)
 #define ACTION_JOYSTICK_R_MAX          ACTION_NONE // No action for right joystick max
 
 // ============================================================================
@@ -76,10 +125,37 @@
 // ============================================================================
 // Right side buttons (R1-R4)
 
-#define ACTION_BTN_R1                  MOUSE_LEFT
-#define ACTION_BTN_R2                  KEY_SPACE   // Top button
-#define ACTION_BTN_R3                  KEY_R       // Middle button
-#define ACTION_BTN_R4                  KEY_E       // Bottom button
+#define ACTION_BTN_R1                  ACTION_MOUSE(MOUSE_LEFT)
+#define ACTION_BTN_R2                  ACTION_KEYCODE(KEY_SPACE)   // Top button
+#define ACTION_BTN_R3                  ACTION_KEYCODE(KEY_R)       // Middle button
+#define ACTION_BTN_R4                  ACTION_KEYCODE(KEY_E)       // Bottom button
+
+// ============================================================================
+// Alternate Layer Actions
+// ============================================================================
+// Used while a button bound to ACTION_LAYER(LAYER_ALT) is held. Buttons left
+// ACTION_TRANSPARENT keep their base layer action. No button switches layers
+// by default: only the stick clicks are wired until ENABLE_FACE_BUTTONS is set
+// (see docs/configuration.md). Example, auto-fire on R1 while L4 is held:
+//   #define ACTION_BTN_L4              ACTION_LAYER(LAYER_ALT)
+//   #define ACTION_ALT_BTN_R1          ACTION_TURBO(ACTION_MOUSE(MOUSE_LEFT))
+
+#define ACTION_ALT_JOYSTICK_L_PRESS    ACTION_TRANSPARENT
+#define ACTION_ALT_JOYSTICK_R_PRESS    ACTION_TRANSPARENT
+#define ACTION_ALT_BTN_L1              ACTION_TRANSPARENT
+#define ACTION_ALT_BTN_L2              ACTION_TRANSPARENT
+#define ACTION_ALT_BTN_L3              ACTION_TRANSPARENT
+#define ACTION_ALT_BTN_L4              ACTION_TRANSPARENT
+#define ACTION_ALT_BTN_R1              ACTION_TRANSPARENT
+#define ACTION_ALT_BTN_R2              ACTION_TRANSPARENT
+#define ACTION_ALT_BTN_R3              ACTION_TRANSPARENT
+#define ACTION_ALT_BTN_R4              ACTION_TRANSPARENT
+
+// ============================================================================
+// Chord Actions
+// ============================================================================
+
+#define ACTION_CHORD_L1_R1             ACTION_KEYCODE(KEY_ESC)     // Both shoulder buttons
 
 // ============================================================================
 // Assignment Summary Table
@@ -3,6 +3,7 @@
 #define GAMEPAD_PINOUT_H
 
 #include <Arduino.h>
+#include "fast_pin.h"
 
 // ============================================================================
 // Gamepad Pin Configuration
@@ -19,6 +20,8 @@
 // Gamepad Enable Pin
 #define PIN_GAMEPAD_ENABLE          4       // Enable/disable gamepad functionality
 
+typedef FastPin<PIN_GAMEPAD_ENABLE> GamepadEnablePin;   // Polled every loop and in idle sleep
+
 // Left Joystick Pins
 #define PIN_JOYSTICK_L_X            A5      // Left joystick X-axis (analog)
 #define PIN_JOYSTICK_L_Y            A4      // Left joystick Y-axis (analog)
@@ -78,6 +81,12 @@ Mouse Sensitivity:
 - Lower values = faster mouse movement
 - Recommended range: 200-1000
 
+Pin conflicts:
+- gamepad.cpp rejects two functions on one port bit at compile time
+  (analog A6..A11 alias digital pins). Face buttons are only checked while
+  ENABLE_FACE_BUTTONS is set, so PIN_BTN_R2 must move off pin 4 before they
+  are enabled.
+
 Thresholds:
 - SPRINT_THRESHOLD: Joystick magnitude needed for sprint activation
 - JOYSTICK_SIDE_MAX: Maximum joystick value before clipping
@@ -1,5 +1,12 @@
 #include "gamepad_utils.h"
 #include "config.h"
+#include "macros.h"
+#include "hires_mouse.h"
+#include "nkro_keyboard.h"
+#include "key_pulse.h"
+#include "tunables.h"
+#include "console.h"
+#include "cycle_profile.h"
 #include <math.h>
 
 // ============================================================================
@@ -12,14 +19,6 @@ void initializeJoystick(JoystickData& joystick, int xPin, int yPin, int selPin)
     joystick.selPin = selPin;
     joystick.xZero = 0;
     joystick.yZero = 0;
-    joystick.xValue = 0;
-    joystick.yValue = 0;
-    joystick.magnitude = 0;
-    joystick.selFlag = 0;
-    joystick.xPosPressed = false;
-    joystick.xNegPressed = false;
-    joystick.yPosPressed = false;
-    joystick.yNegPressed = false;
     
     pinMode(xPin, INPUT);
     pinMode(yPin, INPUT);
@@ -31,18 +30,15 @@ void calibrateJoystick(JoystickData& joystick) {
     joystick.yZero = analogRead(joystick.yPin);
 }
 
-void readJoystick(JoystickData& joystick, int invertX, int invertY) {
-    joystick.yValue = (analogRead(joystick.yPin) - joystick.yZero) * invertY;
-    joystick.xValue = (analogRead(joystick.xPin) - joystick.xZero) * invertX;
-    joystick.magnitude = calculateMagnitude(joystick.xValue, joystick.yValue);
-    
-    // Clip values to maximum
-    joystick.xValue = clipAxisValue(joystick.xValue, JOYSTICK_SIDE_MAX);
-    joystick.yValue = clipAxisValue(joystick.yValue, JOYSTICK_SIDE_MAX);
+void sampleJoysticks(const JoystickData& left, const JoystickData& right, GamepadFrame& frame) {
+    frame.raw[FRAME_AXIS_LY] = analogRead(left.yPin);
+    frame.raw[FRAME_AXIS_LX] = analogRead(left.xPin);
+    frame.raw[FRAME_AXIS_RY] = analogRead(right.yPin);
+    frame.raw[FRAME_AXIS_RX] = analogRead(right.xPin);
 }
 
 // ============================================================================
-// Axis Processing Functions
+// Frame Stages
 // ============================================================================
 
 int clipAxisValue(int value, int maxValue) {
@@ -52,120 +48,199 @@ int clipAxisValue(int value, int maxValue) {
     return value;
 }
 
-void processAxisMovement(JoystickData& joystick, int threshold) {
-    // Process Y-axis (vertical) movement
-    if ((joystick.yValue >= threshold) && (!joystick.yPosPressed)) {
-        joystick.yPosPressed = true;
-        joystick.yNegPressed = false;
-    } else if ((joystick.yValue <= -threshold) && (!joystick.yNegPressed)) {
-        joystick.yNegPressed = true;
-        joystick.yPosPressed = false;
-    } else if ((joystick.yPosPressed && joystick.yValue < threshold) || 
-               (joystick.yNegPressed && joystick.yValue > -threshold)) {
-        joystick.yNegPressed = false;
-        joystick.yPosPressed = false;
+void computeFrameAxes(const JoystickData& left, const JoystickData& right, int sideMax, GamepadFrame& frame) {
+    int lx = (frame.raw[FRAME_AXIS_LX] - left.xZero) * JOYSTICK_L_INVERT_X;
+    int ly = (frame.raw[FRAME_AXIS_LY] - left.yZero) * JOYSTICK_L_INVERT_Y;
+    int rx = (frame.raw[FRAME_AXIS_RX] - right.xZero) * JOYSTICK_R_INVERT_X;
+    int ry = (frame.raw[FRAME_AXIS_RY] - right.yZero) * JOYSTICK_R_INVERT_Y;
+
+    // Sprint follows the full deflection, not the clipped one
+    frame.magnitude = (uint16_t)calculateMagnitude(lx, ly);
+
+    frame.axis[FRAME_AXIS_LX] = clipAxisValue(lx, sideMax);
+    frame.axis[FRAME_AXIS_LY] = clipAxisValue(ly, sideMax);
+    frame.axis[FRAME_AXIS_RX] = clipAxisValue(rx, sideMax);
+    frame.axis[FRAME_AXIS_RY] = clipAxisValue(ry, sideMax);
+}
+
+void computeFrameKeys(const GamepadFrame& previous, GamepadFrame& next, int binaryThreshold, int sprintThreshold) {
+    uint8_t keys = 0;
+
+    #if !KEY_PWM_ENABLED
+    // Directional keys switch at the threshold (with KEY_PWM_ENABLED they are pulsed instead)
+    int x = next.axis[FRAME_AXIS_LX];
+    int y = next.axis[FRAME_AXIS_LY];
+    if (y >= binaryThreshold) keys |= FRAME_KEY_Y_POS;
+    else if (y <= -binaryThreshold) keys |= FRAME_KEY_Y_NEG;
+    if (x >= binaryThreshold) keys |= FRAME_KEY_X_POS;
+    else if (x <= -binaryThreshold) keys |= FRAME_KEY_X_NEG;
+    #endif
+
+    // Sprint releases 20 below its threshold so it does not chatter at the edge
+    if (SPRINT_THRESHOLD_ENABLED) {
+        bool sprint = previous.keys & FRAME_KEY_SPRINT;
+        if (next.magnitude >= sprintThreshold) {
+            sprint = true;
+        } else if (next.magnitude < sprintThreshold - 20) {
+            sprint = false;
+        }
+        if (sprint) keys |= FRAME_KEY_SPRINT;
     }
-    
-    // Process X-axis (horizontal) movement
-    if ((joystick.xValue >= threshold) && (!joystick.xPosPressed)) {
-        joystick.xPosPressed = true;
-        joystick.xNegPressed = false;
-    } else if ((joystick.xValue <= -threshold) && (!joystick.xNegPressed)) {
-        joystick.xNegPressed = true;
-        joystick.xPosPressed = false;
-    } else if ((joystick.xPosPressed && joystick.xValue < threshold) || 
-               (joystick.xNegPressed && joystick.xValue > -threshold)) {
-        joystick.xNegPressed = false;
-        joystick.xPosPressed = false;
+
+    next.keys = keys;
+}
+
+// Keyboard action of each FRAME_KEY_* bit
+static const uint8_t frameKeyActions[] = {
+    ACTION_JOYSTICK_L_UP, ACTION_JOYSTICK_L_DOWN, ACTION_JOYSTICK_L_LEFT,
+    ACTION_JOYSTICK_L_RIGHT, ACTION_JOYSTICK_L_MAX
+};
+
+void emitFrame(const GamepadFrame& previous, const GamepadFrame& next, int mouseSensitivity) {
+    #if KEY_PWM_ENABLED
+    // Directional keys are pulsed from the input tick (applyKeyPulses())
+    setKeyPulseAxes(next.axis[FRAME_AXIS_LX], next.axis[FRAME_AXIS_LY]);
+    #endif
+
+    // Handle mouse movement (right joystick)
+    processMouseMovement(next.axis[FRAME_AXIS_RX], next.axis[FRAME_AXIS_RY], mouseSensitivity);
+
+    // Only keys that changed since the previous frame
+    uint8_t changed = previous.keys ^ next.keys;
+    for (uint8_t i = 0; changed; i++, changed >>= 1) {
+        if (!(changed & 1) || frameKeyActions[i] == ACTION_NONE) {
+            continue;
+        }
+        if (next.keys & (1 << i)) {
+            GamepadKeyboard.press(frameKeyActions[i]);
+        } else {
+            GamepadKeyboard.release(frameKeyActions[i]);
+        }
+        #if DEBUG_PRINT_GAMEPAD
+        if ((1 << i) == FRAME_KEY_SPRINT) {
+            gamepadDebug.println((next.keys & FRAME_KEY_SPRINT) ? "Gamepad: Pressing sprint" : "Gamepad: Releasing sprint");
+        }
+        #endif
     }
 }
 
 // ============================================================================
-// Button Handling Functions
+// Mouse Control Functions
 // ============================================================================
 
-void handleButtonPress(int pin, int& flag, uint8_t key, const char* action) {
-    // Skip processing if action is ACTION_NONE
-    if (key == ACTION_NONE) {
-        return;
+// Scroll accumulators in wheel counts; fractions carry over to the next frame
+static bool scrollActive = false;
+static uint32_t scrollLastUs = 0;
+static float scrollWheel = 0;
+static float scrollPan = 0;
+
+// Wheel counts per second for one axis: quadratic above the deadzone
+static float scrollRate(int value) {
+    int magnitude = abs(value) - SCROLL_DEADZONE;
+    if (magnitude <= 0) {
+        return 0;
     }
-    
-    if ((digitalRead(pin) == 0) && (!flag)) {
-        flag = 1;
-        Keyboard.press(key);
-        #if DEBUG_PRINT_GAMEPAD
-        Serial.print("Gamepad: Pressing ");
-        Serial.println(action);
-        #endif
-    } else if ((digitalRead(pin)) && (flag)) {
-        flag = 0;
-        Keyboard.release(key);
-        #if DEBUG_PRINT_GAMEPAD
-        Serial.print("Gamepad: Releasing ");
-        Serial.println(action);
-        #endif
+    float fraction = (float)magnitude / (tunables.sideMax - SCROLL_DEADZONE);
+    return sgn(value) * fraction * fraction * (SCROLL_MAX_DETENTS_PER_S * GAMEPAD_WHEEL_MULTIPLIER);
+}
+
+// Take the whole counts out of an accumulator, keeping the remainder
+static int8_t takeScrollCounts(float& accumulator) {
+    float counts = accumulator;
+    if (counts > 127) counts = 127;
+    if (counts < -127) counts = -127;
+    int8_t whole = (int8_t)counts;
+    accumulator -= whole;
+    return whole;
+}
+
+static void processScroll(int xValue, int yValue, uint32_t nowUs) {
+    // Scroll distance follows elapsed time, not the number of frames
+    uint32_t elapsedUs = nowUs - scrollLastUs;
+    scrollLastUs = nowUs;
+    if (elapsedUs > SCROLL_MAX_STEP_US) {
+        elapsedUs = SCROLL_MAX_STEP_US;
     }
+
+    // Stick up (negative Y, like the cursor) scrolls up (positive wheel)
+    scrollWheel -= scrollRate(yValue) * elapsedUs * 1e-6;
+    scrollPan += scrollRate(xValue) * elapsedUs * 1e-6;
+
+    int8_t wheel = takeScrollCounts(scrollWheel);
+    int8_t pan = takeScrollCounts(scrollPan);
+    if (wheel == 0 && pan == 0) {
+        return;
+    }
+    #if ENABLE_HIRES_MOUSE
+    GamepadMouse.move(0, 0, wheel, pan);
+    #else
+    GamepadMouse.move(0, 0, wheel);
+    #endif
 }
 
-void handleDirectionalKeys(JoystickData& joystick, uint8_t upKey, uint8_t downKey, 
-                          uint8_t leftKey, uint8_t rightKey, int threshold) {
-    // Handle vertical movement
-    if (joystick.yPosPressed) {
-        if (upKey != ACTION_NONE) Keyboard.press(upKey);
-        if (downKey != ACTION_NONE) Keyboard.release(downKey);
-    } else if (joystick.yNegPressed) {
-        if (downKey != ACTION_NONE) Keyboard.press(downKey);
-        if (upKey != ACTION_NONE) Keyboard.release(upKey);
-    } else {
-        if (upKey != ACTION_NONE) Keyboard.release(upKey);
-        if (downKey != ACTION_NONE) Keyboard.release(downKey);
+void setScrollMode(bool active) {
+    if (active && !scrollActive) {
+        scrollLastUs = micros();
+        scrollWheel = 0;
+        scrollPan = 0;
     }
-    
-    // Handle horizontal movement
-    if (joystick.xPosPressed) {
-        if (leftKey != ACTION_NONE) Keyboard.press(leftKey);
-        if (rightKey != ACTION_NONE) Keyboard.release(rightKey);
-    } else if (joystick.xNegPressed) {
-        if (rightKey != ACTION_NONE) Keyboard.press(rightKey);
-        if (leftKey != ACTION_NONE) Keyboard.release(leftKey);
-    } else {
-        if (leftKey != ACTION_NONE) Keyboard.release(leftKey);
-        if (rightKey != ACTION_NONE) Keyboard.release(rightKey);
+    scrollActive = active;
+}
+
+bool isScrollMode() {
+    return scrollActive;
+}
+
+// Quadratic response: delta = 0.01 * value^2 / sensitivity, clamped to what one report can carry
+static int16_t mouseAxisDelta(int value, int sensitivity) {
+    float delta = 0.01 * (abs(pow(value, 2)) / sensitivity);
+    if (delta > GAMEPAD_MOUSE_DELTA_MAX) {
+        delta = GAMEPAD_MOUSE_DELTA_MAX;
     }
+    return (int16_t)(sgn(value) * (int16_t)delta);
 }
 
-void handleSprintKey(JoystickData& joystick, uint8_t sprintKey, int threshold, bool& active) {
-    // Skip processing if action is ACTION_NONE
-    if (sprintKey == ACTION_NONE) {
+void processMouseMovement(int xValue, int yValue, int sensitivity) {
+    // The stick drives either the cursor or the wheel, so a frame is still one report
+    if (scrollActive) {
+        processScroll(xValue, yValue, micros());
         return;
     }
-    
-    if ((abs(joystick.magnitude) >= threshold) && (!active)) {
-        Keyboard.press(sprintKey);
-        active = true;
-        #if DEBUG_PRINT_GAMEPAD
-        Serial.println("Gamepad: Pressing sprint");
-        #endif
-    } else if ((abs(joystick.magnitude) < (threshold - 20)) && (active)) {
-        Keyboard.release(sprintKey);
-        active = false;
-        #if DEBUG_PRINT_GAMEPAD
-        Serial.println("Gamepad: Releasing sprint");
-        #endif
+    if (xValue == 0 && yValue == 0) {
+        return;
+    }
+    // Both axes in one report; with ENABLE_HIRES_MOUSE the full delta fits
+    GamepadMouse.move(mouseAxisDelta(xValue, sensitivity),
+                      mouseAxisDelta(yValue, sensitivity));
+}
+
+int scaleMouseSensitivity(int sensitivity, uint16_t reportIntervalUs, uint16_t baseIntervalUs) {
+    if (reportIntervalUs == 0) {
+        return sensitivity > 0 ? sensitivity : 1;
     }
+    // Fewer reports need larger steps for the same cursor speed. mouseAxisDelta()
+    // divides by the result, so it must not round down to 0 (0/0 = NaN on a resting axis)
+    uint32_t scaled = (uint32_t)sensitivity * baseIntervalUs / reportIntervalUs;
+    return scaled > 0 ? (int)scaled : 1;
 }
 
 // ============================================================================
-// Mouse Control Functions
+// Report Frame Processing
 // ============================================================================
 
-void processMouseMovement(JoystickData& joystick, int sensitivity) {
-    if (joystick.yValue != 0) {
-        Mouse.move(0, (sgn(joystick.yValue) * 0.01 * (abs(pow(joystick.yValue, 2)) / sensitivity)));
-    }
-    if (joystick.xValue != 0) {
-        Mouse.move((sgn(joystick.xValue) * 0.01 * (abs(pow(joystick.xValue, 2)) / sensitivity)), 0);
-    }
+void processJoystickFrame(const GamepadFrame& previous, GamepadFrame& next,
+                          const JoystickData& left, const JoystickData& right, int mouseSensitivity) {
+    PROFILE_BEGIN(PROF_FRAME_AXES);
+    computeFrameAxes(left, right, tunables.sideMax, next);
+    PROFILE_END(PROF_FRAME_AXES);
+
+    PROFILE_BEGIN(PROF_FRAME_KEYS);
+    computeFrameKeys(previous, next, tunables.binaryThreshold, tunables.sprintThreshold);
+    PROFILE_END(PROF_FRAME_KEYS);
+
+    PROFILE_BEGIN(PROF_FRAME_EMIT);
+    emitFrame(previous, next, mouseSensitivity);
+    PROFILE_END(PROF_FRAME_EMIT);
 }
 
 // ============================================================================
@@ -173,22 +248,22 @@ void processMouseMovement(JoystickData& joystick, int sensitivity) {
 // ============================================================================
 
 void releaseAllKeys() {
-    Keyboard.release(ACTION_JOYSTICK_L_UP);
-    Keyboard.release(ACTION_JOYSTICK_L_DOWN);
-    Keyboard.release(ACTION_JOYSTICK_L_MAX);
-    Keyboard.release(ACTION_JOYSTICK_L_PRESS);
-    Keyboard.release(ACTION_BTN_L2);
-    Keyboard.release(ACTION_BTN_L3);
-    Keyboard.release(ACTION_BTN_L4);
-    Keyboard.release(ACTION_BTN_R2);
-    Keyboard.release(ACTION_BTN_R3);
-    Keyboard.release(ACTION_BTN_R4);
+    stopMacros();
+    #if KEY_PWM_ENABLED
+    releaseKeyPulses();
+    #endif
+    GamepadKeyboard.release(ACTION_JOYSTICK_L_UP);
+    GamepadKeyboard.release(ACTION_JOYSTICK_L_DOWN);
+    GamepadKeyboard.release(ACTION_JOYSTICK_L_LEFT);
+    GamepadKeyboard.release(ACTION_JOYSTICK_L_RIGHT);
+    GamepadKeyboard.release(ACTION_JOYSTICK_L_MAX);
 }
 
 void releaseAllMouseButtons() {
-    Mouse.release(MOUSE_LEFT);
-    Mouse.release(MOUSE_RIGHT);
-    Mouse.move(0, 0);
+    setScrollMode(false);
+    GamepadMouse.release(MOUSE_LEFT);
+    GamepadMouse.release(MOUSE_RIGHT);
+    GamepadMouse.move(0, 0);
 }
 
 // ============================================================================
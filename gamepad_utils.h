@@ -7,17 +7,64 @@
 #include "gamepad_assignment.h"
 
 // ============================================================================
-// Joystick Data Structure
+// Joystick Data Structures
 // ============================================================================
 
+// Pins and calibration of one stick (fixed after setup)
 struct JoystickData {
     int xPin, yPin, selPin;
     int xZero, yZero;
-    int xValue, yValue;
-    float magnitude;
-    int selFlag;
-    bool xPosPressed, xNegPressed;
-    bool yPosPressed, yNegPressed;
+};
+
+// Axis slots of a frame
+enum FrameAxis : uint8_t {
+    FRAME_AXIS_LX = 0,
+    FRAME_AXIS_LY,
+    FRAME_AXIS_RX,
+    FRAME_AXIS_RY,
+    FRAME_AXIS_COUNT
+};
+
+// Keys held by the left stick (GamepadFrame::keys)
+#define FRAME_KEY_Y_POS             0x01    // ACTION_JOYSTICK_L_UP
+#define FRAME_KEY_Y_NEG             0x02    // ACTION_JOYSTICK_L_DOWN
+#define FRAME_KEY_X_POS             0x04    // ACTION_JOYSTICK_L_LEFT
+#define FRAME_KEY_X_NEG             0x08    // ACTION_JOYSTICK_L_RIGHT
+#define FRAME_KEY_SPRINT            0x10    // ACTION_JOYSTICK_L_MAX
+
+// Everything one report frame is computed from and sends. The stages below
+// read the previous frame and write the next one, so a frame can be reset,
+// compared or traced as one block of memory.
+struct GamepadFrame {
+    uint32_t timestampUs;               // Report time
+    int16_t raw[FRAME_AXIS_COUNT];      // Last ADC readings
+    int16_t axis[FRAME_AXIS_COUNT];     // Zeroed, inverted and clipped to sideMax
+    uint16_t magnitude;                 // Left stick deflection before clipping
+    uint16_t inputs;                    // Button levels (INPUT_BIT() mask)
+    uint8_t keys;                       // FRAME_KEY_* bits
+} __attribute__((packed));
+
+static_assert(sizeof(GamepadFrame) == 25, "GamepadFrame must stay packed");
+
+// The frame sent last and the one being built. Samples go into next(); after
+// a report commit() makes it the previous frame and starts the next one from
+// a copy, so readings carry over until the next sample.
+struct GamepadFrameBuffer {
+    GamepadFrame frames[2];
+    uint8_t current;
+
+    const GamepadFrame& previous() const { return frames[current]; }
+    GamepadFrame& next() { return frames[current ^ 1]; }
+
+    void commit() {
+        current ^= 1;
+        frames[current ^ 1] = frames[current];
+    }
+
+    void reset() {
+        memset(frames, 0, sizeof(frames));
+        current = 0;
+    }
 };
 
 // ============================================================================
@@ -26,21 +73,30 @@ struct JoystickData {
 
 // Joystick Management
 void initializeJoystick(JoystickData& joystick, int xPin, int yPin, int selPin);
-void readJoystick(JoystickData& joystick, int invertX, int invertY);
 void calibrateJoystick(JoystickData& joystick);
 
+// Frame Stages: sampling reads the ADC, emitting sends the HID reports, the
+// stages in between only compute the next frame from the previous one
+void sampleJoysticks(const JoystickData& left, const JoystickData& right, GamepadFrame& frame);
+void computeFrameAxes(const JoystickData& left, const JoystickData& right, int sideMax, GamepadFrame& frame);
+void computeFrameKeys(const GamepadFrame& previous, GamepadFrame& next, int binaryThreshold, int sprintThreshold);
+void emitFrame(const GamepadFrame& previous, const GamepadFrame& next, int mouseSensitivity);
+
 // Axis Processing
 int clipAxisValue(int value, int maxValue);
-void processAxisMovement(JoystickData& joystick, int threshold = 200);
-
-// Button Handling
-void handleButtonPress(int pin, int& flag, uint8_t key, const char* action);
-void handleDirectionalKeys(JoystickData& joystick, uint8_t upKey, uint8_t downKey, 
-                          uint8_t leftKey, uint8_t rightKey, int threshold = 200);
-void handleSprintKey(JoystickData& joystick, uint8_t sprintKey, int threshold, bool& active);
 
 // Mouse Control
-void processMouseMovement(JoystickData& joystick, int sensitivity);
+void processMouseMovement(int xValue, int yValue, int sensitivity);
+int scaleMouseSensitivity(int sensitivity, uint16_t reportIntervalUs, uint16_t baseIntervalUs);
+
+// Scroll Mode: while active the right joystick sends wheel/pan instead of cursor movement
+void setScrollMode(bool active);
+bool isScrollMode();
+
+// Report Frame: axes, keys and emit with the current tunables (shared by the
+// firmware loop and the host tools)
+void processJoystickFrame(const GamepadFrame& previous, GamepadFrame& next,
+                          const JoystickData& left, const JoystickData& right, int mouseSensitivity);
 
 // Key Release Management
 void releaseAllKeys();
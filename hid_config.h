@@ -45,6 +45,16 @@
 #define HID_GAMEPAD_REPORT_ID 6
 #endif
 
+// Report ID for the 16-bit relative mouse (hires_mouse.h)
+#ifndef HID_HIRES_MOUSE_REPORT_ID
+#define HID_HIRES_MOUSE_REPORT_ID 7
+#endif
+
+// Report ID for the N-key rollover keyboard (nkro_keyboard.h)
+#ifndef HID_NKRO_KEYBOARD_REPORT_ID
+#define HID_NKRO_KEYBOARD_REPORT_ID 8
+#endif
+
 // Force HID-Project to use Report IDs
 #ifndef HID_USE_REPORT_IDS
 #define HID_USE_REPORT_IDS 1
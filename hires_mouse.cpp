@@ -0,0 +1,150 @@
+#include "hires_mouse.h"
+
+// ============================================================================
+// Report Descriptor
+// ============================================================================
+
+static const uint8_t hiResMouseDescriptor[] PROGMEM = {
+    0x05, 0x01,                         // Usage Page (Generic Desktop)
+    0x09, 0x02,                         // Usage (Mouse)
+    0xA1, 0x01,                         // Collection (Application)
+    0x85, HID_HIRES_MOUSE_REPORT_ID,    //   Report ID
+    0x09, 0x01,                         //   Usage (Pointer)
+    0xA1, 0x00,                         //   Collection (Physical)
+
+    // 5 buttons + 3 bits padding
+    0x05, 0x09,                         //     Usage Page (Button)
+    0x19, 0x01,                         //     Usage Minimum (1)
+    0x29, 0x05,                         //     Usage Maximum (5)
+    0x15, 0x00,                         //     Logical Minimum (0)
+    0x25, 0x01,                         //     Logical Maximum (1)
+    0x95, 0x05,                         //     Report Count (5)
+    0x75, 0x01,                         //     Report Size (1)
+    0x81, 0x02,                         //     Input (Data, Variable, Absolute)
+    0x95, 0x01,                         //     Report Count (1)
+    0x75, 0x03,                         //     Report Size (3)
+    0x81, 0x03,                         //     Input (Constant)
+
+    // X, Y: 16-bit relative
+    0x05, 0x01,                         //     Usage Page (Generic Desktop)
+    0x09, 0x30,                         //     Usage (X)
+    0x09, 0x31,                         //     Usage (Y)
+    0x16, 0x01, 0x80,                   //     Logical Minimum (-32767)
+    0x26, 0xFF, 0x7F,                   //     Logical Maximum (32767)
+    0x75, 0x10,                         //     Report Size (16)
+    0x95, 0x02,                         //     Report Count (2)
+    0x81, 0x06,                         //     Input (Data, Variable, Relative)
+
+    // Wheel with Resolution Multiplier
+    0xA1, 0x02,                         //     Collection (Logical)
+    0x09, 0x48,                         //       Usage (Resolution Multiplier)
+    0x15, 0x00,                         //       Logical Minimum (0)
+    0x25, 0x01,                         //       Logical Maximum (1)
+    0x35, 0x01,                         //       Physical Minimum (1)
+    0x45, HIRES_WHEEL_MULTIPLIER,       //       Physical Maximum
+    0x75, 0x02,                         //       Report Size (2)
+    0x95, 0x01,                         //       Report Count (1)
+    0xB1, 0x02,                         //       Feature (Data, Variable, Absolute)
+    0x35, 0x00,                         //       Physical Minimum (0)
+    0x45, 0x00,                         //       Physical Maximum (0)
+    0x09, 0x38,                         //       Usage (Wheel)
+    0x15, 0x81,                         //       Logical Minimum (-127)
+    0x25, 0x7F,                         //       Logical Maximum (127)
+    0x75, 0x08,                         //       Report Size (8)
+    0x95, 0x01,                         //       Report Count (1)
+    0x81, 0x06,                         //       Input (Data, Variable, Relative)
+    0xC0,                               //     End Collection
+
+    // AC Pan with Resolution Multiplier
+    0xA1, 0x02,                         //     Collection (Logical)
+    0x09, 0x48,                         //       Usage (Resolution Multiplier)
+    0x15, 0x00,                         //       Logical Minimum (0)
+    0x25, 0x01,                         //       Logical Maximum (1)
+    0x35, 0x01,                         //       Physical Minimum (1)
+    0x45, HIRES_WHEEL_MULTIPLIER,       //       Physical Maximum
+    0x75, 0x02,                         //       Report Size (2)
+    0x95, 0x01,                         //       Report Count (1)
+    0xB1, 0x02,                         //       Feature (Data, Variable, Absolute)
+    0x35, 0x00,                         //       Physical Minimum (0)
+    0x45, 0x00,                         //       Physical Maximum (0)
+    0x05, 0x0C,                         //       Usage Page (Consumer)
+    0x0A, 0x38, 0x02,                   //       Usage (AC Pan)
+    0x15, 0x81,                         //       Logical Minimum (-127)
+    0x25, 0x7F,                         //       Logical Maximum (127)
+    0x75, 0x08,                         //       Report Size (8)
+    0x95, 0x01,                         //       Report Count (1)
+    0x81, 0x06,                         //       Input (Data, Variable, Relative)
+    0xC0,                               //     End Collection
+
+    // Pad the two multiplier fields to a full feature byte
+    0x75, 0x04,                         //     Report Size (4)
+    0x95, 0x01,                         //     Report Count (1)
+    0xB1, 0x03,                         //     Feature (Constant)
+
+    0xC0,                               //   End Collection
+    0xC0                                // End Collection
+};
+
+static_assert(HIRES_WHEEL_MULTIPLIER >= 1 && HIRES_WHEEL_MULTIPLIER <= 15,
+              "Physical Maximum is encoded as a single positive byte");
+
+// ============================================================================
+// HiResMouse_
+// ============================================================================
+
+HiResMouse_ HiResMouse;
+
+HiResMouse_::HiResMouse_() : buttons(0) {
+    static HIDSubDescriptor node(hiResMouseDescriptor, sizeof(hiResMouseDescriptor));
+    HID().AppendDescriptor(&node);
+}
+
+void HiResMouse_::begin() {
+    releaseAll();
+}
+
+void HiResMouse_::end() {
+    releaseAll();
+}
+
+void HiResMouse_::report(int16_t x, int16_t y, int8_t wheel, int8_t pan) {
+    HiResMouseReport data;
+    data.buttons = buttons;
+    data.x = x;
+    data.y = y;
+    data.wheel = wheel;
+    data.pan = pan;
+    HID().SendReport(HID_HIRES_MOUSE_REPORT_ID, &data, sizeof(data));
+}
+
+void HiResMouse_::click(uint8_t b) {
+    press(b);
+    release(b);
+}
+
+void HiResMouse_::move(int16_t x, int16_t y, int8_t wheel, int8_t pan) {
+    report(x, y, wheel, pan);
+}
+
+void HiResMouse_::press(uint8_t b) {
+    if ((buttons | b) != buttons) {
+        buttons |= b;
+        report(0, 0, 0, 0);
+    }
+}
+
+void HiResMouse_::release(uint8_t b) {
+    if ((buttons & b) != 0) {
+        buttons &= (uint8_t)~b;
+        report(0, 0, 0, 0);
+    }
+}
+
+void HiResMouse_::releaseAll() {
+    buttons = 0;
+    report(0, 0, 0, 0);
+}
+
+bool HiResMouse_::isPressed(uint8_t b) {
+    return (buttons & b) != 0;
+}
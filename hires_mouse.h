@@ -0,0 +1,69 @@
+#ifndef HIRES_MOUSE_H
+#define HIRES_MOUSE_H
+
+#include <Arduino.h>
+#include <HID.h>
+#include "config.h"
+#include "hid_config.h"
+
+// ============================================================================
+// High-Resolution Mouse
+// ============================================================================
+// Relative mouse with 16-bit X/Y deltas, so a fast stick flick travels its full
+// distance in one report instead of saturating at +-127. Wheel and AC Pan sit
+// in Resolution Multiplier collections. The report is appended to the shared
+// HID interface under its own report ID.
+//
+// The host enables the multiplier with a Feature SET_REPORT, but the core HID
+// class that owns the shared interface drops SET_REPORT data, so the firmware
+// cannot tell whether it was enabled. Counts are therefore sent at a fixed
+// scale: with the default of 1 every host scrolls one detent per count. A
+// larger value gives smooth scrolling on hosts that always enable the
+// multiplier (Windows 8+, Linux 5.0+), but scrolls that many times too fast on
+// hosts that do not (macOS, BIOS/UEFI).
+
+#define HIRES_WHEEL_MULTIPLIER      1       // Wheel counts per detent (1..15), see above
+#define HIRES_MOUSE_DELTA_MAX       32767   // Largest X/Y delta per report
+
+// Input report layout (after the report ID)
+struct HiResMouseReport {
+    uint8_t buttons;        // MOUSE_LEFT, MOUSE_RIGHT, MOUSE_MIDDLE, MOUSE_PREV, MOUSE_NEXT
+    int16_t x;              // Little endian, like the AVR itself
+    int16_t y;
+    int8_t wheel;
+    int8_t pan;
+} __attribute__((packed));
+
+static_assert(sizeof(HiResMouseReport) == 7, "Report size must match the descriptor");
+
+class HiResMouse_ {
+public:
+    HiResMouse_();
+    void begin();
+    void end();
+    void click(uint8_t b = MOUSE_LEFT);
+    void move(int16_t x, int16_t y, int8_t wheel = 0, int8_t pan = 0);
+    void press(uint8_t b = MOUSE_LEFT);
+    void release(uint8_t b = MOUSE_LEFT);
+    void releaseAll();
+    bool isPressed(uint8_t b = MOUSE_LEFT);
+
+private:
+    void report(int16_t x, int16_t y, int8_t wheel, int8_t pan);
+    uint8_t buttons;
+};
+
+extern HiResMouse_ HiResMouse;
+
+// Mouse used by the gamepad code; HID-Project's 8-bit Mouse when disabled
+#if ENABLE_HIRES_MOUSE
+#define GamepadMouse HiResMouse
+#define GAMEPAD_MOUSE_DELTA_MAX HIRES_MOUSE_DELTA_MAX
+#define GAMEPAD_WHEEL_MULTIPLIER HIRES_WHEEL_MULTIPLIER
+#else
+#define GamepadMouse Mouse
+#define GAMEPAD_MOUSE_DELTA_MAX 127
+#define GAMEPAD_WHEEL_MULTIPLIER 1
+#endif
+
+#endif // HIRES_MOUSE_H
@@ -0,0 +1,109 @@
+#include "idle_mode.h"
+#include "gamepad_pinout.h"
+#include "console.h"
+#include <avr/sleep.h>
+#include <avr/power.h>
+
+// ============================================================================
+// Idle State
+// ============================================================================
+
+static IdleStats idleStats = {0, 0, 0, 0};
+static bool wakePending = false;
+static uint32_t wakeUs = 0;
+
+static uint8_t savedADCSRA = 0;
+static uint8_t savedACSR = 0;
+
+// ============================================================================
+// Peripheral Power Control
+// ============================================================================
+
+static void powerDownPeripherals() {
+    // The ADC has to be disabled before its clock is gated
+    savedADCSRA = ADCSRA;
+    ADCSRA &= ~_BV(ADEN);
+    power_adc_disable();
+
+    // Analog comparator, SPI and the hardware USART are not used by the sketch
+    // (Serial is USB CDC)
+    savedACSR = ACSR;
+    ACSR |= _BV(ACD);
+    power_spi_disable();
+    power_usart1_disable();
+}
+
+static void powerUpPeripherals() {
+    power_usart1_enable();
+    power_spi_enable();
+    ACSR = savedACSR;
+
+    power_adc_enable();
+    ADCSRA = savedADCSRA;
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void idleSleep(uint32_t maxSleepMs) {
+    // PIN_GAMEPAD_ENABLE has no pin-change interrupt on the ATmega32U4; the
+    // 1 kHz input tick wakes the CPU often enough to check it after every wake
+    uint32_t start = millis();
+    powerDownPeripherals();
+    set_sleep_mode(SLEEP_MODE_IDLE);
+
+    while (true) {
+        if (!GamepadEnablePin::read()) {
+            // Gamepad switched on: measure from here to its first report
+            wakeUs = micros();
+            wakePending = true;
+            break;
+        }
+        if (millis() - start >= maxSleepMs) {
+            break;
+        }
+        #if ENABLE_SERIAL_CONSOLE
+        if (isConsoleInputPending()) {
+            break;
+        }
+        #endif
+
+        // Any interrupt (Timer0, USB, TWI) ends the sleep
+        sleep_enable();
+        sleep_cpu();
+        sleep_disable();
+        idleStats.wakeups++;
+    }
+
+    powerUpPeripherals();
+    idleStats.idleMs += millis() - start;
+}
+
+void reportWakeLatency() {
+    if (!wakePending) {
+        return;
+    }
+    wakePending = false;
+
+    uint32_t latency = micros() - wakeUs;
+    idleStats.lastWakeToReportUs = latency;
+    if (latency > idleStats.maxWakeToReportUs) {
+        idleStats.maxWakeToReportUs = latency;
+    }
+
+    // JSON status report, same framing as the UPS report
+    Serial.print("{\"idle\":{\"wake_to_report_us\":");
+    Serial.print(idleStats.lastWakeToReportUs);
+    Serial.print(",\"max_wake_to_report_us\":");
+    Serial.print(idleStats.maxWakeToReportUs);
+    Serial.print(",\"wakeups\":");
+    Serial.print(idleStats.wakeups);
+    Serial.print(",\"idle_ms\":");
+    Serial.print(idleStats.idleMs);
+    Serial.println("}}");
+}
+
+const IdleStats& getIdleStats() {
+    return idleStats;
+}
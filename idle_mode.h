@@ -0,0 +1,34 @@
+#ifndef IDLE_MODE_H
+#define IDLE_MODE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ============================================================================
+// Low-Power Idle Mode
+// ============================================================================
+// While the gamepad enable switch is off the CPU is halted in IDLE sleep and
+// the ADC and unused peripherals are powered down. USB, Timer0 (millis and the
+// input tick) and TWI keep running, so the host connection stays up and the
+// UPS is still serviced on time.
+
+struct IdleStats {
+    uint32_t lastWakeToReportUs;    // Wake detection to first gamepad report
+    uint32_t maxWakeToReportUs;     // Worst case since boot
+    uint32_t wakeups;               // CPU wakeups while idle (each interrupt)
+    uint32_t idleMs;                // Total time spent in idle mode
+};
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Sleep until the gamepad enable pin is pulled LOW or maxSleepMs has passed
+void idleSleep(uint32_t maxSleepMs);
+
+// Called by the gamepad once its first report after a wake has been sent
+void reportWakeLatency();
+
+const IdleStats& getIdleStats();
+
+#endif // IDLE_MODE_H
@@ -0,0 +1,146 @@
+#include "input_events.h"
+#include "spsc_queue.h"
+#include "key_pulse.h"
+#include "turbo.h"
+#include "cycle_profile.h"
+#include "fast_pin.h"
+
+// ============================================================================
+// Source Table
+// ============================================================================
+
+// Pin per InputSource, in enum order (setup only; the ISR reads the pins below)
+static const uint8_t inputSourcePins[INPUT_SRC_COUNT] PROGMEM = {
+    PIN_JOYSTICK_L_SEL,
+    PIN_JOYSTICK_R_SEL,
+#if ENABLE_FACE_BUTTONS
+    PIN_BTN_L1, PIN_BTN_L2, PIN_BTN_L3, PIN_BTN_L4,
+    PIN_BTN_R1, PIN_BTN_R2, PIN_BTN_R3, PIN_BTN_R4,
+#endif
+};
+
+// Pressed state of one source as its level-mask bit (active low, one SBIS)
+#define INPUT_PIN_BIT(pin, source)  (FastPin<pin>::read() ? 0 : (uint16_t)1 << (source))
+
+// Current pin levels of all sources, bit n = InputSource n pressed
+static inline uint16_t readInputPins() {
+    return INPUT_PIN_BIT(PIN_JOYSTICK_L_SEL, INPUT_SRC_JOYSTICK_L_SEL)
+         | INPUT_PIN_BIT(PIN_JOYSTICK_R_SEL, INPUT_SRC_JOYSTICK_R_SEL)
+#if ENABLE_FACE_BUTTONS
+         | INPUT_PIN_BIT(PIN_BTN_L1, INPUT_SRC_BTN_L1)
+         | INPUT_PIN_BIT(PIN_BTN_L2, INPUT_SRC_BTN_L2)
+         | INPUT_PIN_BIT(PIN_BTN_L3, INPUT_SRC_BTN_L3)
+         | INPUT_PIN_BIT(PIN_BTN_L4, INPUT_SRC_BTN_L4)
+         | INPUT_PIN_BIT(PIN_BTN_R1, INPUT_SRC_BTN_R1)
+         | INPUT_PIN_BIT(PIN_BTN_R2, INPUT_SRC_BTN_R2)
+         | INPUT_PIN_BIT(PIN_BTN_R3, INPUT_SRC_BTN_R3)
+         | INPUT_PIN_BIT(PIN_BTN_R4, INPUT_SRC_BTN_R4)
+#endif
+         ;
+}
+
+// ============================================================================
+// Capture State (written in interrupt context only)
+// ============================================================================
+
+static SpscQueue<InputEvent, INPUT_EVENT_QUEUE_SIZE> inputQueue;
+static volatile uint16_t inputLevels = 0;           // Bit n set = source n pressed
+static uint16_t lastEdgeMs[INPUT_SRC_COUNT];        // Time of last accepted edge (1.024 ms units)
+
+// Compare current pin levels against the last captured state and queue every
+// change. Called from the Timer0 tick and from the pin interrupts; AVR ISRs do
+// not nest, so this is always the single producer of the queue.
+static void scanInputs() {
+    uint32_t now = micros();
+    uint16_t nowMs = (uint16_t)(now >> 10);
+    uint16_t levels = inputLevels;
+    uint16_t changed = readInputPins() ^ levels;
+
+    for (uint8_t i = 0; changed && i < INPUT_SRC_COUNT; i++) {
+        uint16_t bitMask = (uint16_t)1 << i;
+        if (!(changed & bitMask)) {
+            continue;
+        }
+        changed &= ~bitMask;
+
+        // Ignore contact bounce; the new level is picked up once the window has passed
+        if ((uint16_t)(nowMs - lastEdgeMs[i]) < INPUT_DEBOUNCE_MS) {
+            continue;
+        }
+
+        lastEdgeMs[i] = nowMs;
+        levels ^= bitMask;
+
+        InputEvent event;
+        event.timestampUs = now;
+        event.source = i;
+        event.pressed = (levels & bitMask) != 0;
+        inputQueue.push(event);
+    }
+
+    inputLevels = levels;
+}
+
+// 1 kHz sampling tick for pins without an edge interrupt, also drives the pulse and turbo generators
+ISR(TIMER0_COMPA_vect) {
+    PROFILE_BEGIN(PROF_ISR_INPUT_TICK);
+    scanInputs();
+    #if KEY_PWM_ENABLED
+    keyPulseTick();
+    #endif
+    turboTick();
+    PROFILE_END(PROF_ISR_INPUT_TICK);
+}
+
+// Pin-change interrupt for port B inputs
+ISR(PCINT0_vect) {
+    PROFILE_BEGIN(PROF_ISR_PCINT);
+    scanInputs();
+    PROFILE_END(PROF_ISR_PCINT);
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void setupInputEvents() {
+    for (uint8_t i = 0; i < INPUT_SRC_COUNT; i++) {
+        uint8_t pin = pgm_read_byte(&inputSourcePins[i]);
+        pinMode(pin, INPUT_PULLUP);
+
+        // Capture on the edge itself where the pin supports it
+        if (digitalPinToPCICR(pin)) {
+            *digitalPinToPCICR(pin) |= _BV(digitalPinToPCICRbit(pin));
+            *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+        } else if (digitalPinToInterrupt(pin) != NOT_AN_INTERRUPT) {
+            attachInterrupt(digitalPinToInterrupt(pin), scanInputs, CHANGE);
+        }
+    }
+
+    inputLevels = readInputPins();
+
+    // Timer0 already overflows every 1.024 ms for millis(); a compare match in
+    // the middle of its range gives the sampling tick without touching its setup
+    OCR0A = 0x80;
+    TIMSK0 |= _BV(OCIE0A);
+}
+
+bool popInputEvent(InputEvent& event) {
+    return inputQueue.pop(event);
+}
+
+bool isInputPressed(uint8_t source) {
+    return (getInputLevels() & ((uint16_t)1 << source)) != 0;
+}
+
+uint16_t getInputLevels() {
+    uint16_t levels;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        levels = inputLevels;
+    }
+    return levels;
+}
+
+uint16_t getInputEventsDropped() {
+    return inputQueue.droppedCount();
+}
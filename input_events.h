@@ -0,0 +1,60 @@
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "gamepad_pinout.h"
+
+// ============================================================================
+// Input Event Capture
+// ============================================================================
+// Button edges are captured in interrupt context and queued with a timestamp,
+// so a short press is never lost while the main loop is blocked (UPS I2C read,
+// serial flush, ...). Pins with a pin-change or external interrupt are captured
+// on the edge itself; all other pins are sampled by a 1 kHz tick that shares
+// Timer0 with millis().
+
+// Input sources (bit position in the level mask)
+enum InputSource : uint8_t {
+    INPUT_SRC_JOYSTICK_L_SEL = 0,
+    INPUT_SRC_JOYSTICK_R_SEL,
+#if ENABLE_FACE_BUTTONS
+    INPUT_SRC_BTN_L1,
+    INPUT_SRC_BTN_L2,
+    INPUT_SRC_BTN_L3,
+    INPUT_SRC_BTN_L4,
+    INPUT_SRC_BTN_R1,
+    INPUT_SRC_BTN_R2,
+    INPUT_SRC_BTN_R3,
+    INPUT_SRC_BTN_R4,
+#endif
+    INPUT_SRC_COUNT
+};
+
+static_assert(INPUT_SRC_COUNT <= 16, "Input level mask is 16 bits wide");
+
+struct InputEvent {
+    uint32_t timestampUs;   // micros() when the edge was captured
+    uint8_t source;         // InputSource
+    bool pressed;           // true = pressed (pin pulled LOW)
+};
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+void setupInputEvents();
+
+// Main loop side: returns false when no event is pending
+bool popInputEvent(InputEvent& event);
+
+// Last captured level of a source (true = pressed)
+bool isInputPressed(uint8_t source);
+
+// Last captured levels of all sources (bit n = InputSource n pressed)
+uint16_t getInputLevels();
+
+// Number of edges lost because the queue was full
+uint16_t getInputEventsDropped();
+
+#endif // INPUT_EVENTS_H
@@ -0,0 +1,281 @@
+#include "input_map.h"
+#include "macros.h"
+#include "hires_mouse.h"
+#include "nkro_keyboard.h"
+#include "gamepad_utils.h"
+#include "console.h"
+#include "tunables.h"
+#include "turbo.h"
+
+// ============================================================================
+// Mapping Tables
+// ============================================================================
+
+// Action per layer and InputSource, in enum order
+static const InputAction layerActions[LAYER_COUNT][INPUT_SRC_COUNT] PROGMEM = {
+    {   // LAYER_BASE
+        ACTION_JOYSTICK_L_PRESS, ACTION_JOYSTICK_R_PRESS,
+#if ENABLE_FACE_BUTTONS
+        ACTION_BTN_L1, ACTION_BTN_L2, ACTION_BTN_L3, ACTION_BTN_L4,
+        ACTION_BTN_R1, ACTION_BTN_R2, ACTION_BTN_R3, ACTION_BTN_R4,
+#endif
+    },
+    {   // LAYER_ALT
+        ACTION_ALT_JOYSTICK_L_PRESS, ACTION_ALT_JOYSTICK_R_PRESS,
+#if ENABLE_FACE_BUTTONS
+        ACTION_ALT_BTN_L1, ACTION_ALT_BTN_L2, ACTION_ALT_BTN_L3, ACTION_ALT_BTN_L4,
+        ACTION_ALT_BTN_R1, ACTION_ALT_BTN_R2, ACTION_ALT_BTN_R3, ACTION_ALT_BTN_R4,
+#endif
+    },
+};
+
+struct ChordDef {
+    uint16_t sources;               // INPUT_BIT() mask of the buttons
+    InputAction action;
+};
+
+// Terminated by an entry without sources
+static const ChordDef chordTable[] PROGMEM = {
+#if ENABLE_FACE_BUTTONS
+    { INPUT_BIT(INPUT_SRC_BTN_L1) | INPUT_BIT(INPUT_SRC_BTN_R1), ACTION_CHORD_L1_R1 },
+#endif
+    { 0, ACTION_NONE }
+};
+
+// ============================================================================
+// Mapping State
+// ============================================================================
+
+static uint8_t activeLayer = LAYER_BASE;
+static InputAction heldActions[INPUT_SRC_COUNT];    // Action each pressed source performed
+
+static uint16_t turboSources = 0;       // Held sources bound with ACTION_TURBO()
+static uint16_t turboPressed = 0;       // Turbo sources whose action is currently pressed
+static bool turboStarted = false;       // Generator running
+
+static uint16_t chordMembers = 0;       // Sources that appear in any chord
+static uint16_t pendingSources = 0;     // Chord candidates held back
+static uint32_t pendingSinceUs = 0;     // Capture time of the first candidate
+static uint16_t chordSources = 0;       // Members of the active chord still held
+static InputAction chordAction = ACTION_NONE;
+
+// ============================================================================
+// Actions
+// ============================================================================
+
+static void performAction(InputAction action, bool pressed) {
+    uint8_t value = action & 0xFF;
+    switch (ACTION_TYPE(action)) {
+        case ACTION_TYPE_KEY:
+            if (pressed) GamepadKeyboard.press(value);
+            else GamepadKeyboard.release(value);
+            break;
+        case ACTION_TYPE_KEYCODE:
+            if (pressed) GamepadKeyboard.press((KeyboardKeycode)value);
+            else GamepadKeyboard.release((KeyboardKeycode)value);
+            break;
+        case ACTION_TYPE_MOUSE:
+            if (pressed) GamepadMouse.press(value);
+            else GamepadMouse.release(value);
+            break;
+        case ACTION_TYPE_MACRO:
+            // A macro keeps playing after its button is released
+            if (pressed) startMacro(value);
+            break;
+        case ACTION_TYPE_SCROLL:
+            setScrollMode(pressed);
+            break;
+        default:
+            break;
+    }
+
+    #if DEBUG_PRINT_GAMEPAD
+    gamepadDebug.print(pressed ? "Gamepad: Pressing action 0x" : "Gamepad: Releasing action 0x");
+    gamepadDebug.println(action, HEX);
+    #endif
+}
+
+// Constant-time lookup: active layer, falling back to the base layer once
+static InputAction resolveAction(uint8_t source) {
+    InputAction action = pgm_read_word(&layerActions[activeLayer][source]);
+    if (ACTION_TYPE(action) == ACTION_TYPE_TRANSPARENT) {
+        action = pgm_read_word(&layerActions[LAYER_BASE][source]);
+    }
+    return action;
+}
+
+static void pressSource(uint8_t source) {
+    InputAction action = resolveAction(source);
+    heldActions[source] = action;
+    if (ACTION_TYPE(action) == ACTION_TYPE_LAYER) {
+        activeLayer = (action & 0xFF) < LAYER_COUNT ? (action & 0xFF) : LAYER_BASE;
+    } else if (action & ACTION_FLAG_TURBO) {
+        // Pressed by applyTurbo() on the next report frame
+        turboSources |= INPUT_BIT(source);
+    } else {
+        performAction(action, true);
+    }
+}
+
+// Releases the action the source pressed, even if the layer changed since
+static void releaseSource(uint8_t source) {
+    InputAction action = heldActions[source];
+    heldActions[source] = ACTION_NONE;
+    if (ACTION_TYPE(action) == ACTION_TYPE_LAYER) {
+        activeLayer = LAYER_BASE;
+    } else if (action & ACTION_FLAG_TURBO) {
+        uint16_t bit = INPUT_BIT(source);
+        if (turboPressed & bit) {
+            performAction(action, false);
+        }
+        turboPressed &= ~bit;
+        turboSources &= ~bit;
+        if (!turboSources) {
+            stopTurbo();
+            turboStarted = false;
+        }
+    } else {
+        performAction(action, false);
+    }
+}
+
+// ============================================================================
+// Chord Detection
+// ============================================================================
+
+// Chord matching the candidates exactly, or nullptr. *canGrow is set when a
+// chord contains all candidates plus more, i.e. waiting may still complete it.
+static const ChordDef* findChord(uint16_t sources, bool* canGrow) {
+    *canGrow = false;
+    for (const ChordDef* chord = chordTable; ; chord++) {
+        uint16_t members = pgm_read_word(&chord->sources);
+        if (members == 0) {
+            return nullptr;
+        }
+        if (members == sources) {
+            return chord;
+        }
+        if ((members & sources) == sources) {
+            *canGrow = true;
+        }
+    }
+}
+
+// Candidates did not form a chord: they act as individual presses
+static void flushPending() {
+    for (uint8_t source = 0; source < INPUT_SRC_COUNT; source++) {
+        if (pendingSources & INPUT_BIT(source)) {
+            pressSource(source);
+        }
+    }
+    pendingSources = 0;
+}
+
+static void pressChordCandidate(uint8_t source, uint32_t timestampUs) {
+    if (pendingSources == 0) {
+        pendingSinceUs = timestampUs;
+    }
+    pendingSources |= INPUT_BIT(source);
+
+    bool canGrow;
+    const ChordDef* chord = findChord(pendingSources, &canGrow);
+    if (chord) {
+        chordAction = pgm_read_word(&chord->action);
+        chordSources = pendingSources;
+        pendingSources = 0;
+        performAction(chordAction, true);
+    } else if (!canGrow) {
+        flushPending();
+    }
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void setupInputMap() {
+    chordMembers = 0;
+    for (const ChordDef* chord = chordTable; pgm_read_word(&chord->sources) != 0; chord++) {
+        chordMembers |= pgm_read_word(&chord->sources);
+    }
+    resetInputMap();
+}
+
+void mapInputEvent(const InputEvent& event) {
+    if (event.source >= INPUT_SRC_COUNT) {
+        return;
+    }
+    uint16_t bit = INPUT_BIT(event.source);
+
+    if (event.pressed) {
+        if (chordMembers & bit) {
+            pressChordCandidate(event.source, event.timestampUs);
+        } else {
+            pressSource(event.source);
+        }
+        return;
+    }
+
+    if (pendingSources & bit) {
+        // Released inside the window: it was a tap, not a chord
+        flushPending();
+        releaseSource(event.source);
+    } else if (chordSources & bit) {
+        // The chord ends with its first released member
+        if (chordAction != ACTION_NONE) {
+            performAction(chordAction, false);
+            chordAction = ACTION_NONE;
+        }
+        chordSources &= ~bit;
+    } else if (heldActions[event.source] != ACTION_NONE) {
+        releaseSource(event.source);
+    }
+}
+
+void loopInputMap(uint32_t nowUs) {
+    if (pendingSources && (nowUs - pendingSinceUs >= (uint32_t)CHORD_WINDOW_MS * 1000UL)) {
+        flushPending();
+    }
+}
+
+void applyTurbo() {
+    if (!turboSources) {
+        return;
+    }
+
+    // First turbo button: start the generator in its press phase on this frame
+    if (!turboStarted) {
+        startTurbo(tunables.turboRateHz);
+        turboStarted = true;
+    }
+
+    uint16_t target = getTurboPhase() ? turboSources : 0;
+    uint16_t changed = target ^ turboPressed;
+    for (uint8_t source = 0; changed && source < INPUT_SRC_COUNT; source++) {
+        uint16_t bit = INPUT_BIT(source);
+        if (changed & bit) {
+            performAction(heldActions[source], (target & bit) != 0);
+            changed &= ~bit;
+        }
+    }
+    turboPressed = target;
+}
+
+void resetInputMap() {
+    for (uint8_t source = 0; source < INPUT_SRC_COUNT; source++) {
+        if (heldActions[source] != ACTION_NONE) {
+            releaseSource(source);
+        }
+    }
+    if (chordAction != ACTION_NONE) {
+        performAction(chordAction, false);
+        chordAction = ACTION_NONE;
+    }
+    chordSources = 0;
+    pendingSources = 0;
+    activeLayer = LAYER_BASE;
+}
+
+uint8_t getActiveLayer() {
+    return activeLayer;
+}
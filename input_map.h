@@ -0,0 +1,41 @@
+#ifndef INPUT_MAP_H
+#define INPUT_MAP_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "input_events.h"
+
+// ============================================================================
+// Input Mapping (Layers and Chords)
+// ============================================================================
+// Resolves captured button edges to actions. Each source has one action per
+// layer in a PROGMEM table, so resolution is a single indexed lookup. Holding a
+// button bound to ACTION_LAYER(n) switches the table. Buttons that belong to a
+// chord are held back for up to CHORD_WINDOW_MS to see whether the rest of the
+// chord follows; all other buttons act immediately.
+
+typedef uint16_t InputAction;       // ACTION_* encoding from gamepad_assignment.h
+
+#define INPUT_BIT(source)           ((uint16_t)1 << (source))
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+void setupInputMap();
+
+// Resolve a captured edge and press/release its action
+void mapInputEvent(const InputEvent& event);
+
+// Resolve pending chord candidates whose window has passed (call every loop)
+void loopInputMap(uint32_t nowUs);
+
+// Press/release held ACTION_TURBO() actions on a phase change (call once per report frame)
+void applyTurbo();
+
+// Release every held action and return to the base layer
+void resetInputMap();
+
+uint8_t getActiveLayer();
+
+#endif // INPUT_MAP_H
@@ -0,0 +1,98 @@
+#include "input_trace.h"
+
+// ============================================================================
+// Recorder State
+// ============================================================================
+
+static bool traceActive = false;
+static bool headerPending = false;
+static uint16_t traceReportIntervalUs = 0;
+static uint32_t traceFrames = 0;
+static uint32_t traceDropped = 0;
+
+// Append value as lowercase hex without leading zeros, returns new length
+static uint8_t appendHex(char* buf, uint8_t len, uint32_t value) {
+    static const char digits[] = "0123456789abcdef";
+    char tmp[8];
+    uint8_t n = 0;
+    do {
+        tmp[n++] = digits[value & 0x0F];
+        value >>= 4;
+    } while (value && n < sizeof(tmp));
+    while (n) {
+        buf[len++] = tmp[--n];
+    }
+    return len;
+}
+
+static void writeHeader(const JoystickData& left, const JoystickData& right, uint16_t reportIntervalUs) {
+    Serial.print("#trace v1 zero ");
+    Serial.print(left.xZero);
+    Serial.print(' ');
+    Serial.print(left.yZero);
+    Serial.print(' ');
+    Serial.print(right.xZero);
+    Serial.print(' ');
+    Serial.print(right.yZero);
+    Serial.print(" report_us ");
+    Serial.println(reportIntervalUs);
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void startInputTrace() {
+    traceActive = true;
+    headerPending = true;
+}
+
+void stopInputTrace() {
+    traceActive = false;
+}
+
+bool isInputTraceActive() {
+    return traceActive;
+}
+
+void traceInputFrame(const GamepadFrame& frame, const JoystickData& left, const JoystickData& right,
+                     uint16_t reportIntervalUs) {
+    if (!traceActive) {
+        return;
+    }
+
+    // Calibration and report rate are needed to replay the frames that follow
+    if (headerPending || reportIntervalUs != traceReportIntervalUs) {
+        writeHeader(left, right, reportIntervalUs);
+        traceReportIntervalUs = reportIntervalUs;
+        headerPending = false;
+    }
+
+    char line[INPUT_TRACE_LINE_MAX];
+    uint8_t len = 0;
+    line[len++] = '@';
+    len = appendHex(line, len, frame.timestampUs);
+    for (uint8_t axis = 0; axis < FRAME_AXIS_COUNT; axis++) {
+        line[len++] = ',';
+        len = appendHex(line, len, (uint16_t)frame.raw[axis]);
+    }
+    line[len++] = ',';
+    len = appendHex(line, len, frame.inputs);
+    line[len++] = '\n';
+
+    // Never block the gamepad loop on a slow or absent reader
+    if (Serial.availableForWrite() < len) {
+        traceDropped++;
+        return;
+    }
+    Serial.write((const uint8_t*)line, len);
+    traceFrames++;
+}
+
+uint32_t getInputTraceFrames() {
+    return traceFrames;
+}
+
+uint32_t getInputTraceDropped() {
+    return traceDropped;
+}
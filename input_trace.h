@@ -0,0 +1,38 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "gamepad_utils.h"
+
+// ============================================================================
+// Input Trace Recorder
+// ============================================================================
+// Streams one compact text line per report frame over Serial so field issues
+// can be replayed on the host (tools/trace_replay.cpp). Lines never collide
+// with the JSON telemetry:
+//
+//   #trace v1 zero <lxZero> <lyZero> <rxZero> <ryZero> report_us <interval>
+//   @<timestamp_us>,<lxRaw>,<lyRaw>,<rxRaw>,<ryRaw>,<buttons>     (all hex)
+//
+// The header is repeated whenever the report interval changes. A frame is
+// dropped rather than blocking when the USB buffer has no room for it.
+
+#define INPUT_TRACE_LINE_MAX        40
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+void startInputTrace();
+void stopInputTrace();
+bool isInputTraceActive();
+
+// Time, ADC readings and button levels of a frame; the sticks carry the calibration
+void traceInputFrame(const GamepadFrame& frame, const JoystickData& left, const JoystickData& right,
+                     uint16_t reportIntervalUs);
+
+uint32_t getInputTraceFrames();
+uint32_t getInputTraceDropped();
+
+#endif // INPUT_TRACE_H
@@ -0,0 +1,91 @@
+#include "key_pulse.h"
+#include "nkro_keyboard.h"
+#include <util/atomic.h>
+
+// ============================================================================
+// Pulse State
+// ============================================================================
+
+struct PulseAxis {
+    uint8_t onTicks;                // Key-down ticks per period
+    uint8_t keyBit;                 // KEY_PULSE_* of the deflected direction
+};
+
+static volatile PulseAxis pulseAxes[2];             // X, Y (written by the main loop)
+static volatile uint8_t pulseKeys = 0;              // Keys down in the current tick (written by the ISR)
+static uint8_t pulsePhase = 0;                      // Position in the period (ISR only)
+static uint8_t appliedKeys = 0;                     // Keys currently pressed (main loop only)
+
+// Same key orientation as handleDirectionalKeys()
+static const uint8_t pulseKeyActions[4] = {
+    ACTION_JOYSTICK_L_UP, ACTION_JOYSTICK_L_DOWN, ACTION_JOYSTICK_L_LEFT, ACTION_JOYSTICK_L_RIGHT
+};
+
+// Duty cycle in ticks: off below KEY_PWM_MIN_DEFLECTION, held from KEY_PWM_FULL_DEFLECTION
+static uint8_t deflectionToTicks(int value) {
+    int deflection = abs(value);
+    if (deflection < KEY_PWM_MIN_DEFLECTION) {
+        return 0;
+    }
+    if (deflection >= KEY_PWM_FULL_DEFLECTION) {
+        return KEY_PWM_PERIOD_MS;
+    }
+    return (uint8_t)((uint32_t)(deflection - KEY_PWM_MIN_DEFLECTION) * KEY_PWM_PERIOD_MS /
+                     (KEY_PWM_FULL_DEFLECTION - KEY_PWM_MIN_DEFLECTION));
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void setKeyPulseAxes(int xValue, int yValue) {
+    uint8_t xTicks = deflectionToTicks(xValue);
+    uint8_t yTicks = deflectionToTicks(yValue);
+    uint8_t xBit = xValue > 0 ? KEY_PULSE_LEFT : KEY_PULSE_RIGHT;
+    uint8_t yBit = yValue > 0 ? KEY_PULSE_UP : KEY_PULSE_DOWN;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        pulseAxes[0].onTicks = xTicks;
+        pulseAxes[0].keyBit = xBit;
+        pulseAxes[1].onTicks = yTicks;
+        pulseAxes[1].keyBit = yBit;
+    }
+}
+
+void keyPulseTick() {
+    if (++pulsePhase >= KEY_PWM_PERIOD_MS) {
+        pulsePhase = 0;
+    }
+
+    uint8_t keys = 0;
+    if (pulsePhase < pulseAxes[0].onTicks) keys |= pulseAxes[0].keyBit;
+    if (pulsePhase < pulseAxes[1].onTicks) keys |= pulseAxes[1].keyBit;
+    pulseKeys = keys;
+}
+
+void applyKeyPulses() {
+    uint8_t keys = pulseKeys;
+    uint8_t changed = keys ^ appliedKeys;
+    if (!changed) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t bit = 1 << i;
+        if (!(changed & bit) || pulseKeyActions[i] == ACTION_NONE) {
+            continue;
+        }
+        if (keys & bit) {
+            GamepadKeyboard.press(pulseKeyActions[i]);
+        } else {
+            GamepadKeyboard.release(pulseKeyActions[i]);
+        }
+    }
+    appliedKeys = keys;
+}
+
+void releaseKeyPulses() {
+    setKeyPulseAxes(0, 0);
+    pulseKeys = 0;
+    applyKeyPulses();
+}
@@ -0,0 +1,40 @@
+#ifndef KEY_PULSE_H
+#define KEY_PULSE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ============================================================================
+// Proportional Movement Keys
+// ============================================================================
+// With KEY_PWM_ENABLED the left stick direction keys are pulsed with a duty
+// cycle proportional to deflection instead of being held past a threshold.
+// The pulse pattern is generated in the 1 kHz input tick (Timer0 compare A);
+// the main loop only forwards key state changes to the keyboard report.
+
+// Direction key bits
+#define KEY_PULSE_UP                0x01
+#define KEY_PULSE_DOWN              0x02
+#define KEY_PULSE_LEFT              0x04
+#define KEY_PULSE_RIGHT             0x08
+
+static_assert(KEY_PWM_PERIOD_MS > 0 && KEY_PWM_PERIOD_MS <= 255, "Pulse period is counted in 8 bits");
+static_assert(KEY_PWM_FULL_DEFLECTION > KEY_PWM_MIN_DEFLECTION, "Deflection range is empty");
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Set the duty cycles from the left stick axis values (report frame)
+void setKeyPulseAxes(int xValue, int yValue);
+
+// Advance the pulse pattern by one tick (interrupt context)
+void keyPulseTick();
+
+// Press/release direction keys whose pulse state changed (call every loop)
+void applyKeyPulses();
+
+// Stop pulsing and release all direction keys
+void releaseKeyPulses();
+
+#endif // KEY_PULSE_H
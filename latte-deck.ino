@@ -7,26 +7,55 @@
 
 #include "config.h"
 #include "usb_config.h"
+#include "hires_mouse.h"
+#include "nkro_keyboard.h"
 #include "gamepad.h"
 #include "ups_simple.h"
+#include "idle_mode.h"
+#include "perf_governor.h"
+#include "console.h"
+#include "watchdog.h"
+#include "cycle_profile.h"
+#include "persist_store.h"
 
 int gamepadStatus = -1;
 
 void setup() {
+    // State preserved across a watchdog or reset-button restart
+    #if ENABLE_WATCHDOG
+    bool warmRestart = beginWarmState();
+    #else
+    bool warmRestart = false;
+    #endif
+
     // Initialize serial communication
     Serial.begin(115200);
-    delay(3000); // Give serial time to initialize
+    if (!warmRestart) {
+        delay(3000); // Give serial time to initialize
+    }
     Serial.println("Starting LatteDeck...");
+
+    #if ENABLE_CYCLE_PROFILE
+    setupCycleProfile();
+    #endif
+    #if ENABLE_WATCHDOG
+    reportResetReason();
+    #endif
     
     // USB configuration is handled through Arduino IDE board settings
     // and the USB_VID and USB_PID definitions in usb_config.h
     // The Leonardo doesn't support runtime USB descriptor changes
     
     // Initialize NicoHood HID for mouse and keyboard functionality
-    Mouse.begin();
-    Keyboard.begin();
+    GamepadMouse.begin();
+    GamepadKeyboard.begin();
     Serial.println("NicoHood HID initialized");
 
+    // Index the EEPROM store before calibration and UPS restore from it
+    #if ENABLE_PERSIST_STORE
+    beginPersistStore();
+    #endif
+
     setupGamepad();
     Serial.println("Gamepad setup completed");
 
@@ -37,16 +66,82 @@ void setup() {
     } else {
         Serial.println("UPS setup failed - continuing without UPS");
     }
+
+    // Resume the profile that was active before a warm restart
+    #if ENABLE_PERF_GOVERNOR && ENABLE_WATCHDOG
+    restorePerfGovernor();
+    #endif
+    #endif
+
+    #if ENABLE_WATCHDOG
+    startWatchdog();
     #endif
 
     Serial.println("LatteDeck ready!");
 }
 
 void loop() {
+  // Each stage feeds the watchdog, so a hang is reported with the stage it happened in
+  #if ENABLE_WATCHDOG
+  feedWatchdog(WD_STAGE_GAMEPAD);
+  #endif
+  PROFILE_BEGIN(PROF_LOOP_GAMEPAD);
   loopGamepad();
+  PROFILE_END(PROF_LOOP_GAMEPAD);
+
+  // Live tuning commands (non-blocking)
+  #if ENABLE_SERIAL_CONSOLE
+  #if ENABLE_WATCHDOG
+  feedWatchdog(WD_STAGE_CONSOLE);
+  #endif
+  loopConsole();
+  #endif
   
   // Update UPS functionality (non-blocking)
   #if ENABLE_HID_POWER_DEVICE
+  #if ENABLE_WATCHDOG
+  feedWatchdog(WD_STAGE_UPS);
+  #endif
+  PROFILE_BEGIN(PROF_UPS_UPDATE);
   loopSimpleUPS();
+  PROFILE_END(PROF_UPS_UPDATE);
+
+  // Adapt sampling, report and LED rates to the battery state
+  #if ENABLE_PERF_GOVERNOR
+  #if ENABLE_WATCHDOG
+  feedWatchdog(WD_STAGE_GOVERNOR);
+  #endif
+  updatePerfGovernor(simple_ups.getStatus());
+  #endif
+  #endif
+
+  // Background EEPROM writes, one byte per loop
+  #if ENABLE_PERSIST_STORE
+  #if ENABLE_WATCHDOG
+  feedWatchdog(WD_STAGE_PERSIST);
+  #endif
+  loopPersistStore();
+  #endif
+
+  #if ENABLE_CYCLE_PROFILE
+  loopCycleProfile();
+  #endif
+
+  // Sleep while the gamepad is switched off, until it is switched on again
+  // or the UPS needs service
+  #if ENABLE_IDLE_SLEEP
+  if (isGamepadDisabled()) {
+    uint32_t sleepMs = IDLE_MAX_SLEEP_MS;
+    #if ENABLE_HID_POWER_DEVICE
+    uint32_t upsMs = simple_ups.msUntilNextUpdate();
+    if (upsMs < sleepMs) {
+      sleepMs = upsMs;
+    }
+    #endif
+    #if ENABLE_WATCHDOG
+    feedWatchdog(WD_STAGE_IDLE);
+    #endif
+    idleSleep(sleepMs);
+  }
   #endif
 }
@@ -0,0 +1,114 @@
+#include "macros.h"
+#include "hires_mouse.h"
+#include "nkro_keyboard.h"
+
+// ============================================================================
+// Macro Definitions
+// ============================================================================
+// One bytecode sequence per MacroId, terminated by M_END. Keys are raw HID
+// keycodes (KEY_*), so modifiers and function keys can be used as well.
+
+static const uint8_t macroQuickSwap[] PROGMEM = {
+    M_TAP(KEY_2, 30), M_WAIT(50), M_TAP(KEY_1, 30), M_END
+};
+
+static const uint8_t* const macroTable[MACRO_COUNT] PROGMEM = {
+    macroQuickSwap,     // MACRO_QUICK_SWAP
+};
+
+// ============================================================================
+// Player State
+// ============================================================================
+
+#define MACRO_MAX_HELD_KEYS         6       // Keys a macro may hold at once (boot keyboard report)
+
+static const uint8_t* macroPc = nullptr;   // Next step, nullptr when idle
+static uint32_t macroNextStepMs = 0;       // Due time of the next step
+static uint8_t macroHeldKeys[MACRO_MAX_HELD_KEYS];
+static uint8_t macroHeldMouse = 0;
+
+static void trackKey(uint8_t key, bool down) {
+    for (uint8_t i = 0; i < MACRO_MAX_HELD_KEYS; i++) {
+        if (down && macroHeldKeys[i] == KEY_RESERVED) {
+            macroHeldKeys[i] = key;
+            return;
+        }
+        if (!down && macroHeldKeys[i] == key) {
+            macroHeldKeys[i] = KEY_RESERVED;
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+bool startMacro(uint8_t id) {
+    if (id >= MACRO_COUNT || macroPc) {
+        return false;
+    }
+    macroPc = (const uint8_t*)pgm_read_ptr(&macroTable[id]);
+    macroNextStepMs = millis();
+    return true;
+}
+
+void loopMacros(uint32_t nowMs) {
+    // Run every step that is due; waits advance the schedule rather than
+    // restarting it from now, so a late loop does not stretch the sequence
+    while (macroPc && (int32_t)(nowMs - macroNextStepMs) >= 0) {
+        uint8_t op = pgm_read_byte(macroPc++);
+        switch (op) {
+            case MACRO_OP_KEY_DOWN: {
+                uint8_t key = pgm_read_byte(macroPc++);
+                GamepadKeyboard.press((KeyboardKeycode)key);
+                trackKey(key, true);
+                break;
+            }
+            case MACRO_OP_KEY_UP: {
+                uint8_t key = pgm_read_byte(macroPc++);
+                GamepadKeyboard.release((KeyboardKeycode)key);
+                trackKey(key, false);
+                break;
+            }
+            case MACRO_OP_WAIT:
+                macroNextStepMs += pgm_read_word(macroPc);
+                macroPc += 2;
+                break;
+            case MACRO_OP_MOUSE_DOWN: {
+                uint8_t button = pgm_read_byte(macroPc++);
+                GamepadMouse.press(button);
+                macroHeldMouse |= button;
+                break;
+            }
+            case MACRO_OP_MOUSE_UP: {
+                uint8_t button = pgm_read_byte(macroPc++);
+                GamepadMouse.release(button);
+                macroHeldMouse &= ~button;
+                break;
+            }
+            default:
+                // MACRO_OP_END (or a malformed step)
+                macroPc = nullptr;
+                break;
+        }
+    }
+}
+
+void stopMacros() {
+    macroPc = nullptr;
+    for (uint8_t i = 0; i < MACRO_MAX_HELD_KEYS; i++) {
+        if (macroHeldKeys[i] != KEY_RESERVED) {
+            GamepadKeyboard.release((KeyboardKeycode)macroHeldKeys[i]);
+            macroHeldKeys[i] = KEY_RESERVED;
+        }
+    }
+    if (macroHeldMouse) {
+        GamepadMouse.release(macroHeldMouse);
+        macroHeldMouse = 0;
+    }
+}
+
+bool isMacroPlaying() {
+    return macroPc != nullptr;
+}
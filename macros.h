@@ -0,0 +1,53 @@
+#ifndef MACROS_H
+#define MACROS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ============================================================================
+// Macro Engine
+// ============================================================================
+// Multi-key sequences stored as PROGMEM bytecode and played back from the main
+// loop clock. Playback never blocks: each call to loopMacros() runs the steps
+// that are due and returns at the next wait. Bind a macro to a button with
+// ACTION_MACRO(id) in gamepad_assignment.h.
+
+// Bytecode opcodes
+#define MACRO_OP_END                0x00
+#define MACRO_OP_KEY_DOWN           0x01    // + KeyboardKeycode
+#define MACRO_OP_KEY_UP             0x02    // + KeyboardKeycode
+#define MACRO_OP_WAIT               0x03    // + uint16 ms (little endian)
+#define MACRO_OP_MOUSE_DOWN         0x04    // + MOUSE_* button mask
+#define MACRO_OP_MOUSE_UP           0x05    // + MOUSE_* button mask
+
+// Step helpers for macro definitions
+#define M_DOWN(key)                 MACRO_OP_KEY_DOWN, (uint8_t)(key)
+#define M_UP(key)                   MACRO_OP_KEY_UP, (uint8_t)(key)
+#define M_WAIT(ms)                  MACRO_OP_WAIT, (uint8_t)((ms) & 0xFF), (uint8_t)((ms) >> 8)
+#define M_TAP(key, ms)              M_DOWN(key), M_WAIT(ms), M_UP(key)
+#define M_CLICK_DOWN(button)        MACRO_OP_MOUSE_DOWN, (uint8_t)(button)
+#define M_CLICK_UP(button)          MACRO_OP_MOUSE_UP, (uint8_t)(button)
+#define M_END                       MACRO_OP_END
+
+// Macro IDs (index into the table in macros.cpp)
+enum MacroId : uint8_t {
+    MACRO_QUICK_SWAP = 0,           // Tap 2, then 1: switch weapon and back
+    MACRO_COUNT
+};
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Start a macro; ignored while another macro is playing
+bool startMacro(uint8_t id);
+
+// Run the steps that are due (call every loop)
+void loopMacros(uint32_t nowMs);
+
+// Abort playback and release everything the macro pressed
+void stopMacros();
+
+bool isMacroPlaying();
+
+#endif // MACROS_H
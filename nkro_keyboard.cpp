@@ -0,0 +1,161 @@
+#include "nkro_keyboard.h"
+
+#if ENABLE_NKRO_KEYBOARD
+
+// ============================================================================
+// Report Descriptor
+// ============================================================================
+
+static const uint8_t nkroKeyboardDescriptor[] PROGMEM = {
+    0x05, 0x01,                         // Usage Page (Generic Desktop)
+    0x09, 0x06,                         // Usage (Keyboard)
+    0xA1, 0x01,                         // Collection (Application)
+    0x85, HID_NKRO_KEYBOARD_REPORT_ID,  //   Report ID
+    0x05, 0x07,                         //   Usage Page (Keyboard/Keypad)
+
+    // 8 modifier bits
+    0x19, 0xE0,                         //   Usage Minimum (Left Control)
+    0x29, 0xE7,                         //   Usage Maximum (Right GUI)
+    0x15, 0x00,                         //   Logical Minimum (0)
+    0x25, 0x01,                         //   Logical Maximum (1)
+    0x75, 0x01,                         //   Report Size (1)
+    0x95, 0x08,                         //   Report Count (8)
+    0x81, 0x02,                         //   Input (Data, Variable, Absolute)
+
+    // One bit per key
+    0x19, 0x00,                         //   Usage Minimum (0)
+    0x29, NKRO_KEY_COUNT - 1,           //   Usage Maximum
+    0x95, NKRO_KEY_COUNT,               //   Report Count
+    0x81, 0x02,                         //   Input (Data, Variable, Absolute)
+
+    0xC0                                // End Collection
+};
+
+static_assert(NKRO_KEY_COUNT % 8 == 0 && NKRO_KEY_COUNT <= 0x80, "Bitmap must be whole bytes of single-byte usages");
+
+// ============================================================================
+// ASCII to Keycode (US layout)
+// ============================================================================
+
+#define NKRO_SHIFT                  0x80    // Character needs shift
+
+// Printable ASCII 0x20..0x7E
+static const uint8_t nkroAsciiMap[] PROGMEM = {
+    0x2C,              0x1E | NKRO_SHIFT, 0x34 | NKRO_SHIFT, 0x20 | NKRO_SHIFT,   //  !"#
+    0x21 | NKRO_SHIFT, 0x22 | NKRO_SHIFT, 0x24 | NKRO_SHIFT, 0x34,                // $%&'
+    0x26 | NKRO_SHIFT, 0x27 | NKRO_SHIFT, 0x25 | NKRO_SHIFT, 0x2E | NKRO_SHIFT,   // ()*+
+    0x36,              0x2D,              0x37,              0x38,                // ,-./
+    0x27, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,                   // 0-9
+    0x33 | NKRO_SHIFT, 0x33,              0x36 | NKRO_SHIFT, 0x2E,                // :;<=
+    0x37 | NKRO_SHIFT, 0x38 | NKRO_SHIFT, 0x1F | NKRO_SHIFT,                      // >?@
+    0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x8D, 0x8E, 0x8F, 0x90, // A-M
+    0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, // N-Z
+    0x2F,              0x31,              0x30,              0x23 | NKRO_SHIFT,   // [\]^
+    0x2D | NKRO_SHIFT, 0x35,                                                      // _`
+    0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, // a-m
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, // n-z
+    0x2F | NKRO_SHIFT, 0x31 | NKRO_SHIFT, 0x30 | NKRO_SHIFT, 0x35 | NKRO_SHIFT,   // {|}~
+};
+
+static_assert(sizeof(nkroAsciiMap) == 0x7F - 0x20, "One entry per printable character");
+
+static uint8_t asciiToKeycode(uint8_t c) {
+    if (c >= 0x20 && c < 0x7F) return pgm_read_byte(&nkroAsciiMap[c - 0x20]);
+    switch (c) {
+        case '\b': return KEY_BACKSPACE;
+        case '\t': return KEY_TAB;
+        case '\n': return KEY_ENTER;
+        case 0x1B: return KEY_ESC;
+        default:   return KEY_RESERVED;
+    }
+}
+
+// ============================================================================
+// NkroKeyboard_
+// ============================================================================
+
+NkroKeyboard_ NkroKeyboard;
+
+NkroKeyboard_::NkroKeyboard_() : dirty(false) {
+    memset(&state, 0, sizeof(state));
+    memset(&sent, 0, sizeof(sent));
+    static HIDSubDescriptor node(nkroKeyboardDescriptor, sizeof(nkroKeyboardDescriptor));
+    HID().AppendDescriptor(&node);
+}
+
+void NkroKeyboard_::begin() {
+    releaseAll();
+    flush();
+}
+
+void NkroKeyboard_::end() {
+    releaseAll();
+    flush();
+}
+
+void NkroKeyboard_::send() {
+    HID().SendReport(HID_NKRO_KEYBOARD_REPORT_ID, &state, sizeof(state));
+    sent = state;
+    dirty = false;
+}
+
+bool NkroKeyboard_::setKey(uint8_t key, bool pressed) {
+    uint8_t* byte;
+    uint8_t bit;
+    if (key >= KEY_LEFT_CTRL && key <= KEY_RIGHT_GUI) {
+        byte = &state.modifiers;
+        bit = 1 << (key - KEY_LEFT_CTRL);
+    } else if (key != KEY_RESERVED && key < NKRO_KEY_COUNT) {
+        byte = &state.keys[key >> 3];
+        bit = 1 << (key & 7);
+    } else {
+        return false;
+    }
+
+    if (pressed) {
+        *byte |= bit;
+    } else if (*byte & bit) {
+        // Pressed and released within one frame: send the press first
+        uint8_t* sentByte = (uint8_t*)&sent + (byte - (uint8_t*)&state);
+        if (!(*sentByte & bit)) {
+            send();
+        }
+        *byte &= ~bit;
+    }
+    dirty = true;
+    return true;
+}
+
+size_t NkroKeyboard_::press(KeyboardKeycode key) {
+    return setKey(key, true) ? 1 : 0;
+}
+
+size_t NkroKeyboard_::release(KeyboardKeycode key) {
+    return setKey(key, false) ? 1 : 0;
+}
+
+size_t NkroKeyboard_::press(uint8_t ascii) {
+    uint8_t code = asciiToKeycode(ascii);
+    if (code & NKRO_SHIFT) setKey(KEY_LEFT_SHIFT, true);
+    return setKey(code & ~NKRO_SHIFT, true) ? 1 : 0;
+}
+
+size_t NkroKeyboard_::release(uint8_t ascii) {
+    uint8_t code = asciiToKeycode(ascii);
+    if (code & NKRO_SHIFT) setKey(KEY_LEFT_SHIFT, false);
+    return setKey(code & ~NKRO_SHIFT, false) ? 1 : 0;
+}
+
+void NkroKeyboard_::releaseAll() {
+    memset(&state, 0, sizeof(state));
+    dirty = true;
+}
+
+void NkroKeyboard_::flush() {
+    if (dirty && memcmp(&state, &sent, sizeof(state)) != 0) {
+        send();
+    }
+    dirty = false;
+}
+
+#endif // ENABLE_NKRO_KEYBOARD
@@ -0,0 +1,73 @@
+#ifndef NKRO_KEYBOARD_H
+#define NKRO_KEYBOARD_H
+
+#include <Arduino.h>
+#include <HID.h>
+#include <HID-Project.h>
+#include "config.h"
+#include "hid_config.h"
+
+// ============================================================================
+// N-Key Rollover Keyboard
+// ============================================================================
+// Keyboard report with one bit per key instead of a 6-key array, so movement
+// keys, sprint and any number of button keys can be held at once. press() and
+// release() only change the bitmap; flush() sends it once per frame, so a
+// diagonal sprint plus a button is one USB transfer instead of one per call.
+// A key released in the same frame it was pressed is sent pressed first, so a
+// tap is never lost. The report is appended to the shared HID interface under
+// its own report ID.
+
+#define NKRO_KEY_COUNT              120     // Usages 0x00..0x77 (A-Z, digits, F1-F24, arrows, keypad)
+#define NKRO_KEY_BYTES              (NKRO_KEY_COUNT / 8)
+
+// Input report layout (after the report ID)
+struct NkroKeyboardReport {
+    uint8_t modifiers;                  // KEY_LEFT_CTRL..KEY_RIGHT_GUI as bits 0-7
+    uint8_t keys[NKRO_KEY_BYTES];       // Bit n of byte n/8 = usage n
+} __attribute__((packed));
+
+static_assert(sizeof(NkroKeyboardReport) == 16, "Report size must match the descriptor");
+
+class NkroKeyboard_ {
+public:
+    NkroKeyboard_();
+    void begin();
+    void end();
+
+    // ASCII characters (US layout) and raw keycodes, like HID-Project's Keyboard
+    size_t press(uint8_t ascii);
+    size_t release(uint8_t ascii);
+    size_t press(KeyboardKeycode key);
+    size_t release(KeyboardKeycode key);
+    void releaseAll();
+
+    // Send the report if it changed since the last flush (call once per frame)
+    void flush();
+
+private:
+    bool setKey(uint8_t key, bool pressed);
+    void send();
+
+    NkroKeyboardReport state;
+    NkroKeyboardReport sent;
+    bool dirty;
+};
+
+extern NkroKeyboard_ NkroKeyboard;
+
+// Keyboard used by the gamepad code; HID-Project's 6KRO Keyboard (one report per call) when disabled
+#if ENABLE_NKRO_KEYBOARD
+#define GamepadKeyboard NkroKeyboard
+#else
+#define GamepadKeyboard Keyboard
+#endif
+
+// End of a gamepad frame
+inline void flushGamepadKeyboard() {
+    #if ENABLE_NKRO_KEYBOARD
+    NkroKeyboard.flush();
+    #endif
+}
+
+#endif // NKRO_KEYBOARD_H
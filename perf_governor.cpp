@@ -0,0 +1,105 @@
+#include "perf_governor.h"
+#include "watchdog.h"
+
+// ============================================================================
+// Profile Table
+// ============================================================================
+// Kept in RAM (21 bytes) so the active profile can be handed out by reference.
+
+static const PerfProfile perfProfiles[PERF_PROFILE_COUNT] = {
+    // ADC us, Report us, LED animation,         UPS poll ms
+    {  1000,   1000,      UPS_LED_ANIM_FULL,     UPS_READ_INTERVAL_MS },  // Performance
+    {  2000,   4000,      UPS_LED_ANIM_MINIMAL,  6000 },                  // Balanced
+    {  4000,   8000,      UPS_LED_ANIM_OFF,      12000 },                 // Saver
+};
+
+static uint8_t activeProfileId = PERF_PROFILE_PERFORMANCE;
+static uint32_t lastEvaluatedUpdateMs = 0;
+
+// ============================================================================
+// Profile Selection
+// ============================================================================
+
+// Target profile for a status. The thresholds of the current profile and the
+// ones below it are raised by the hysteresis margin, so stepping down happens
+// at the threshold but stepping back up needs GOV_HYSTERESIS_PERCENT more.
+static uint8_t selectProfile(const SimpleUPSStatus& status, uint8_t current) {
+    if (status.is_charging) {
+        return PERF_PROFILE_PERFORMANCE;
+    }
+
+    uint16_t saverLimit = GOV_SAVER_PERCENT;
+    uint16_t balancedLimit = GOV_BALANCED_PERCENT;
+    if (current >= PERF_PROFILE_SAVER) saverLimit += GOV_HYSTERESIS_PERCENT;
+    if (current >= PERF_PROFILE_BALANCED) balancedLimit += GOV_HYSTERESIS_PERCENT;
+
+    if (status.capacity_percent <= saverLimit) return PERF_PROFILE_SAVER;
+    if (status.capacity_percent <= balancedLimit) return PERF_PROFILE_BALANCED;
+    return PERF_PROFILE_PERFORMANCE;
+}
+
+static void setProfile(uint8_t id) {
+    activeProfileId = id;
+    const PerfProfile& profile = perfProfiles[id];
+
+    simple_ups.setPollInterval(profile.upsPollIntervalMs);
+    simple_ups.setLedAnimation(profile.ledAnimation);
+
+    #if ENABLE_WATCHDOG
+    saveWarmProfile(id);
+    #endif
+}
+
+static void applyProfile(uint8_t id, const SimpleUPSStatus& status) {
+    setProfile(id);
+
+    // JSON status report, same framing as the UPS report
+    Serial.print("{\"governor\":{\"profile\":\"");
+    Serial.print(getPerfProfileName(id));
+    Serial.print("\",\"capacity_percent\":");
+    Serial.print(status.capacity_percent);
+    Serial.print(",\"is_charging\":");
+    Serial.print(status.is_charging ? "true" : "false");
+    Serial.println("}}");
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void updatePerfGovernor(const SimpleUPSStatus& status) {
+    // Only re-evaluate on fresh data from a responding UPS
+    if (!status.is_connected || status.last_update_ms == lastEvaluatedUpdateMs) {
+        return;
+    }
+    lastEvaluatedUpdateMs = status.last_update_ms;
+
+    uint8_t target = selectProfile(status, activeProfileId);
+    if (target != activeProfileId) {
+        applyProfile(target, status);
+    }
+}
+
+void restorePerfGovernor() {
+    const WarmState& warm = getWarmState();
+    if (isWarmRestart() && (warm.validMask & WARM_VALID_PROFILE) && warm.perfProfile < PERF_PROFILE_COUNT) {
+        setProfile(warm.perfProfile);
+    }
+}
+
+const PerfProfile& getActivePerfProfile() {
+    return perfProfiles[activeProfileId];
+}
+
+uint8_t getActivePerfProfileId() {
+    return activeProfileId;
+}
+
+const char* getPerfProfileName(uint8_t id) {
+    switch (id) {
+        case PERF_PROFILE_PERFORMANCE: return "performance";
+        case PERF_PROFILE_BALANCED:    return "balanced";
+        case PERF_PROFILE_SAVER:       return "saver";
+        default:                       return "unknown";
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef PERF_GOVERNOR_H
+#define PERF_GOVERNOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "ups_simple.h"
+
+// ============================================================================
+// Governor Configuration
+// ============================================================================
+
+#define GOV_BALANCED_PERCENT        30      // Enter balanced profile at or below this SoC
+#define GOV_SAVER_PERCENT           10      // Enter saver profile at or below this SoC
+#define GOV_HYSTERESIS_PERCENT      5       // SoC margin required to step back up
+
+// ============================================================================
+// Performance Profiles
+// ============================================================================
+// The governor picks a profile from the UPS charge state and applies it to the
+// gamepad sampling/report rates and the UPS poll interval and LED animation.
+
+enum PerfProfileId : uint8_t {
+    PERF_PROFILE_PERFORMANCE = 0,   // On AC or comfortable charge: full rate
+    PERF_PROFILE_BALANCED,          // Low battery: halved rates
+    PERF_PROFILE_SAVER,             // Critical battery: minimum useful rates
+    PERF_PROFILE_COUNT
+};
+
+struct PerfProfile {
+    uint16_t adcSampleIntervalUs;   // Joystick ADC sampling period
+    uint16_t hidReportIntervalUs;   // Mouse/keyboard movement report period
+    uint8_t ledAnimation;           // UpsLedAnimation
+    uint16_t upsPollIntervalMs;     // Battery data poll period
+};
+
+// Report interval of the performance profile; mouse speed is scaled against it
+#define PERF_BASE_REPORT_INTERVAL_US    1000
+#define PERF_MAX_REPORT_INTERVAL_US     8000    // Report interval of the saver profile, the slowest
+
+// Smallest mouse sensitivity that still scales to 1 at the slowest report interval
+#define PERF_MIN_MOUSE_SENSITIVITY      (PERF_MAX_REPORT_INTERVAL_US / PERF_BASE_REPORT_INTERVAL_US)
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Evaluate the UPS status and switch profile if needed (cheap when nothing changed)
+void updatePerfGovernor(const SimpleUPSStatus& status);
+
+// Re-apply the profile saved before a warm restart (watchdog.h); no-op after a cold start
+void restorePerfGovernor();
+
+const PerfProfile& getActivePerfProfile();
+uint8_t getActivePerfProfileId();
+const char* getPerfProfileName(uint8_t id);
+
+#endif // PERF_GOVERNOR_H
@@ -0,0 +1,299 @@
+#include "persist_store.h"
+
+#if ENABLE_PERSIST_STORE
+
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+
+static_assert(PERSIST_EEPROM_BASE + PERSIST_PAGE_SIZE * PERSIST_PAGE_COUNT <= E2END + 1,
+              "Store exceeds the EEPROM");
+
+// Record layout
+#define RECORD_KEY                  0
+#define RECORD_SIZE                 1
+#define RECORD_SEQ                  2
+#define RECORD_DATA                 4
+#define RECORD_LENGTH(size)         ((size) + PERSIST_RECORD_OVERHEAD)
+#define PERSIST_MAX_RECORD          RECORD_LENGTH(PERSIST_MAX_DATA)
+
+#define PAGE_NONE                   0xFF
+
+// ============================================================================
+// State
+// ============================================================================
+
+// Newest record of each key
+struct PersistIndexEntry {
+    uint16_t address;
+    uint16_t seq;
+    uint8_t size;
+    bool valid;
+};
+
+static PersistIndexEntry persistIndex[PERSIST_KEY_COUNT];
+
+// Head: next free byte, as page and offset
+static uint8_t headPage = 0;
+static uint8_t headOffset = 0;
+static uint16_t nextSeq = 0;
+
+// Page whose live records still have to be copied forward
+static uint8_t reclaimPage = PAGE_NONE;
+
+// Values waiting to be written
+static uint8_t pendingData[PERSIST_KEY_COUNT][PERSIST_MAX_DATA];
+static uint8_t pendingSize[PERSIST_KEY_COUNT];
+static uint8_t pendingMask = 0;
+static uint8_t lastSavedKey = PERSIST_KEY_COUNT - 1;
+
+// Record being written, one byte per loopPersistStore() call
+static uint8_t record[PERSIST_MAX_RECORD];
+static uint8_t recordLength = 0;
+static uint8_t recordStep = 0;
+static uint16_t recordAddress = 0;
+static bool recordHasTerminator = false;
+
+static uint32_t lastRecordMs = 0;
+static uint16_t recordCount = 0;
+
+// ============================================================================
+// EEPROM Helpers
+// ============================================================================
+
+static uint16_t pageAddress(uint8_t page) {
+    return PERSIST_EEPROM_BASE + (uint16_t)page * PERSIST_PAGE_SIZE;
+}
+
+static uint8_t pageOf(uint16_t address) {
+    return (address - PERSIST_EEPROM_BASE) / PERSIST_PAGE_SIZE;
+}
+
+static uint8_t* eepromPtr(uint16_t address) {
+    return (uint8_t*)(uintptr_t)address;
+}
+
+static uint8_t readByte(uint16_t address) {
+    return eeprom_read_byte(eepromPtr(address));
+}
+
+static uint16_t recordCrc(const uint8_t* bytes, uint8_t length) {
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < length; i++) {
+        crc = _crc16_update(crc, bytes[i]);
+    }
+    return crc;
+}
+
+// Sequence numbers wrap; the ring holds far fewer than 32768 records
+static bool seqNewer(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) > 0;
+}
+
+// Read and check the record at an address; its length, or 0 if there is none
+static uint8_t loadRecord(uint16_t address, uint8_t offset, uint8_t* bytes) {
+    if (offset + PERSIST_RECORD_OVERHEAD > PERSIST_PAGE_SIZE) {
+        return 0;
+    }
+    bytes[RECORD_KEY] = readByte(address + RECORD_KEY);
+    bytes[RECORD_SIZE] = readByte(address + RECORD_SIZE);
+    if (bytes[RECORD_KEY] >= PERSIST_KEY_COUNT || bytes[RECORD_SIZE] > PERSIST_MAX_DATA) {
+        return 0;
+    }
+
+    uint8_t length = RECORD_LENGTH(bytes[RECORD_SIZE]);
+    if (offset + length > PERSIST_PAGE_SIZE) {
+        return 0;
+    }
+    eeprom_read_block(bytes, eepromPtr(address), length);
+
+    uint16_t crc = bytes[length - 2] | ((uint16_t)bytes[length - 1] << 8);
+    return recordCrc(bytes, length - 2) == crc ? length : 0;
+}
+
+// ============================================================================
+// Boot Scan
+// ============================================================================
+
+void beginPersistStore() {
+    memset(persistIndex, 0, sizeof(persistIndex));
+    reclaimPage = PAGE_NONE;
+    recordLength = 0;
+    uint8_t bytes[PERSIST_MAX_RECORD];
+    bool haveHead = false;
+    uint16_t headSeq = 0;
+
+    // One pass over every page: index the newest record per key and the newest overall
+    for (uint8_t page = 0; page < PERSIST_PAGE_COUNT; page++) {
+        uint8_t offset = 0;
+        uint8_t length;
+        while ((length = loadRecord(pageAddress(page) + offset, offset, bytes)) != 0) {
+            uint8_t key = bytes[RECORD_KEY];
+            uint16_t seq = bytes[RECORD_SEQ] | ((uint16_t)bytes[RECORD_SEQ + 1] << 8);
+
+            PersistIndexEntry& entry = persistIndex[key];
+            if (!entry.valid || seqNewer(seq, entry.seq)) {
+                entry.address = pageAddress(page) + offset;
+                entry.seq = seq;
+                entry.size = bytes[RECORD_SIZE];
+                entry.valid = true;
+            }
+            offset += length;
+
+            if (!haveHead || seqNewer(seq, headSeq)) {
+                haveHead = true;
+                headSeq = seq;
+                headPage = page;
+                headOffset = offset;
+            }
+        }
+    }
+    nextSeq = haveHead ? headSeq + 1 : 0;
+
+    // The page after the head must be clean before the head can enter it
+    uint8_t next = (headPage + 1) % PERSIST_PAGE_COUNT;
+    if (readByte(pageAddress(next)) != PERSIST_KEY_ERASED) {
+        reclaimPage = next;
+    }
+}
+
+bool persistRestore(uint8_t key, void* data, uint8_t size) {
+    if (key >= PERSIST_KEY_COUNT || !persistIndex[key].valid || persistIndex[key].size != size) {
+        return false;
+    }
+    eeprom_read_block(data, eepromPtr(persistIndex[key].address + RECORD_DATA), size);
+    return true;
+}
+
+// ============================================================================
+// Saving
+// ============================================================================
+
+void persistSave(uint8_t key, const void* data, uint8_t size) {
+    if (key >= PERSIST_KEY_COUNT || size > PERSIST_MAX_DATA) {
+        return;
+    }
+
+    // Nothing to do if the stored value is already this one
+    uint8_t mask = 1 << key;
+    const PersistIndexEntry& entry = persistIndex[key];
+    if (!(pendingMask & mask) && entry.valid && entry.size == size) {
+        const uint8_t* bytes = (const uint8_t*)data;
+        uint8_t i = 0;
+        while (i < size && readByte(entry.address + RECORD_DATA + i) == bytes[i]) {
+            i++;
+        }
+        if (i == size) {
+            return;
+        }
+    }
+
+    memcpy(pendingData[key], data, size);
+    pendingSize[key] = size;
+    pendingMask |= mask;
+}
+
+// Start appending a record at the head. Returns false if the head had to move
+// to the next page first; the record is then retried after the reclaim.
+static bool beginRecord(uint8_t key, const uint8_t* data, uint8_t size) {
+    uint8_t length = RECORD_LENGTH(size);
+    if (headOffset + length > PERSIST_PAGE_SIZE) {
+        headPage = (headPage + 1) % PERSIST_PAGE_COUNT;
+        headOffset = 0;
+        reclaimPage = (headPage + 1) % PERSIST_PAGE_COUNT;
+        return false;
+    }
+
+    record[RECORD_KEY] = key;
+    record[RECORD_SIZE] = size;
+    record[RECORD_SEQ] = nextSeq & 0xFF;
+    record[RECORD_SEQ + 1] = nextSeq >> 8;
+    memcpy(&record[RECORD_DATA], data, size);
+    uint16_t crc = recordCrc(record, length - 2);
+    record[length - 2] = crc & 0xFF;
+    record[length - 1] = crc >> 8;
+
+    recordAddress = pageAddress(headPage) + headOffset;
+    recordLength = length;
+    recordHasTerminator = headOffset + length < PERSIST_PAGE_SIZE;
+    recordStep = 0;
+    return true;
+}
+
+// Write the next byte of the record: body, then an end marker behind it, then
+// the key byte that makes the record valid
+static void writeRecordStep() {
+    if (recordStep < recordLength - 1) {
+        eeprom_write_byte(eepromPtr(recordAddress + 1 + recordStep), record[1 + recordStep]);
+        recordStep++;
+        return;
+    }
+    if (recordStep == recordLength - 1) {
+        recordStep++;
+        if (recordHasTerminator) {
+            eeprom_write_byte(eepromPtr(recordAddress + recordLength), PERSIST_KEY_ERASED);
+            return;
+        }
+    }
+
+    eeprom_write_byte(eepromPtr(recordAddress), record[RECORD_KEY]);
+
+    PersistIndexEntry& entry = persistIndex[record[RECORD_KEY]];
+    entry.address = recordAddress;
+    entry.seq = nextSeq++;
+    entry.size = record[RECORD_SIZE];
+    entry.valid = true;
+
+    headOffset += recordLength;
+    recordLength = 0;
+    recordCount++;
+}
+
+void loopPersistStore() {
+    if (!eeprom_is_ready()) {
+        return;
+    }
+    if (recordLength) {
+        writeRecordStep();
+        return;
+    }
+
+    // Copy the live records of the page ahead of the head forward, then mark it empty
+    if (reclaimPage != PAGE_NONE) {
+        for (uint8_t key = 0; key < PERSIST_KEY_COUNT; key++) {
+            const PersistIndexEntry& entry = persistIndex[key];
+            if (entry.valid && pageOf(entry.address) == reclaimPage) {
+                uint8_t data[PERSIST_MAX_DATA];
+                eeprom_read_block(data, eepromPtr(entry.address + RECORD_DATA), entry.size);
+                beginRecord(key, data, entry.size);
+                return;
+            }
+        }
+        eeprom_write_byte(eepromPtr(pageAddress(reclaimPage)), PERSIST_KEY_ERASED);
+        reclaimPage = PAGE_NONE;
+        return;
+    }
+
+    if (!pendingMask || millis() - lastRecordMs < PERSIST_MIN_WRITE_MS) {
+        return;
+    }
+
+    // Keys take turns, so a value saved every interval cannot starve the others
+    for (uint8_t i = 0; i < PERSIST_KEY_COUNT; i++) {
+        uint8_t key = (lastSavedKey + 1 + i) % PERSIST_KEY_COUNT;
+        uint8_t mask = 1 << key;
+        if (pendingMask & mask) {
+            if (beginRecord(key, pendingData[key], pendingSize[key])) {
+                pendingMask &= ~mask;
+                lastSavedKey = key;
+                lastRecordMs = millis();
+            }
+            return;
+        }
+    }
+}
+
+uint16_t getPersistRecordCount() {
+    return recordCount;
+}
+
+#endif // ENABLE_PERSIST_STORE
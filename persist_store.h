@@ -0,0 +1,72 @@
+#ifndef PERSIST_STORE_H
+#define PERSIST_STORE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ============================================================================
+// Persistent Store (EEPROM)
+// ============================================================================
+// A small log-structured key/value store for state that survives a power-off.
+// Every save appends a record (key, size, sequence number, data, CRC-16) at the
+// head of a ring of pages; the newest valid record of a key wins. Writing moves
+// round robin through the whole area, so each cell is written about once per
+// lap instead of once per save.
+//
+// A record's key byte is written last, so a record torn by a power loss reads
+// as the end of the page and is ignored. When the head enters a page, the live
+// records of the following page are copied forward and that page is marked
+// empty, keeping one clean page ahead of the head at all times.
+//
+// beginPersistStore() scans the area once at boot and indexes the newest record
+// of each key. Saves only update a RAM copy; loopPersistStore() writes one
+// EEPROM byte per call while the EEPROM is idle (a byte takes 3.4 ms), and
+// starts at most one new record per PERSIST_MIN_WRITE_MS.
+//
+// Wear: a lap of 512 bytes holds ~28 records, so 100k cycles per cell allow
+// ~2.8M records, over 5 years at the throttle limit of one record per minute.
+
+#define PERSIST_EEPROM_BASE         0       // First EEPROM byte of the store
+#define PERSIST_PAGE_SIZE           64      // Records never span pages
+#define PERSIST_PAGE_COUNT          8       // Ring length (512 of the 1024 bytes)
+#define PERSIST_MAX_DATA            16      // Largest value
+#define PERSIST_MIN_WRITE_MS        60000UL // Throttle between new records
+
+#define PERSIST_RECORD_OVERHEAD     6       // Key, size, sequence (2), CRC-16 (2)
+#define PERSIST_KEY_ERASED          0xFF    // Key byte of an empty slot
+
+// Stored values
+enum PersistKey : uint8_t {
+    PERSIST_KEY_CALIBRATION = 0,    // PersistCalibration
+    PERSIST_KEY_UPS_STATUS,         // SimpleUPSStatus (last battery estimate)
+    PERSIST_KEY_COUNT
+};
+
+// Joystick zeros: left X/Y, right X/Y
+struct PersistCalibration {
+    int16_t joystickZero[4];
+};
+
+static_assert(PERSIST_KEY_COUNT * (PERSIST_MAX_DATA + PERSIST_RECORD_OVERHEAD) <= PERSIST_PAGE_SIZE,
+              "Live records of one page must fit into a clean page");
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Index the stored records (call once in setup(), before any restore)
+void beginPersistStore();
+
+// Copy the newest stored value of a key; false if there is none of this size
+bool persistRestore(uint8_t key, void* data, uint8_t size);
+
+// Queue a new value; identical values are not written again
+void persistSave(uint8_t key, const void* data, uint8_t size);
+
+// Background writer: call from loop()
+void loopPersistStore();
+
+// Records appended since boot (saves and copies)
+uint16_t getPersistRecordCount();
+
+#endif // PERSIST_STORE_H
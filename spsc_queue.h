@@ -0,0 +1,71 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <Arduino.h>
+#include <util/atomic.h>
+
+// ============================================================================
+// Lock-free Single-Producer / Single-Consumer Queue
+// ============================================================================
+// One side (typically an ISR) only ever writes head, the other side (the main
+// loop) only ever writes tail. Both indices are single bytes, so every load
+// and store is atomic on AVR and neither side has to mask interrupts.
+// Indices run freely and are masked on access, so Size must be a power of two.
+
+// Compiler barrier: keeps element accesses on the correct side of the index update
+#define SPSC_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+template <typename T, uint8_t Size>
+class SpscQueue {
+    static_assert(Size >= 2 && Size <= 128 && (Size & (Size - 1)) == 0,
+                  "SpscQueue size must be a power of two between 2 and 128");
+
+public:
+    SpscQueue() : head(0), tail(0), dropped(0) {}
+
+    // Producer side - returns false (and counts a drop) when the queue is full
+    bool push(const T& item) {
+        uint8_t h = head;
+        if ((uint8_t)(h - tail) >= Size) {
+            if (dropped != 0xFFFF) dropped++;
+            return false;
+        }
+        buffer[h & (Size - 1)] = item;
+        SPSC_BARRIER();
+        head = h + 1;
+        return true;
+    }
+
+    // Consumer side - returns false when the queue is empty
+    bool pop(T& item) {
+        uint8_t t = tail;
+        if (t == head) {
+            return false;
+        }
+        SPSC_BARRIER();
+        item = buffer[t & (Size - 1)];
+        SPSC_BARRIER();
+        tail = t + 1;
+        return true;
+    }
+
+    bool isEmpty() const { return head == tail; }
+    uint8_t count() const { return (uint8_t)(head - tail); }
+
+    // Number of items rejected because the queue was full (saturates at 0xFFFF)
+    uint16_t droppedCount() const {
+        uint16_t value;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            value = dropped;
+        }
+        return value;
+    }
+
+private:
+    T buffer[Size];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint16_t dropped;
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,142 @@
+#include "status_led.h"
+#include "cycle_profile.h"
+#include "fast_pin.h"
+#include "ups_simple.h"
+
+// ============================================================================
+// Gamma Table
+// ============================================================================
+// Perceived brightness 0-255 to PWM duty 0-LED_DUTY_MAX, gamma 2.2
+
+static const uint8_t LED_GAMMA[256] PROGMEM = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   8,   9,   9,  10,  10,  10,  11,  11,  11,
+     12,  12,  13,  13,  14,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,
+     19,  20,  20,  21,  22,  22,  23,  23,  24,  24,  25,  26,  26,  27,  28,  28,
+     29,  30,  30,  31,  32,  32,  33,  34,  34,  35,  36,  37,  37,  38,  39,  40,
+     41,  41,  42,  43,  44,  45,  46,  46,  47,  48,  49,  50,  51,  52,  53,  54,
+     54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,
+     71,  72,  73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,
+     89,  90,  91,  93,  94,  95,  96,  98,  99, 100, 102, 103, 104, 106, 107, 108,
+    110, 111, 112, 114, 115, 117, 118, 120, 121, 122, 124, 125, 127, 128, 130, 131,
+    133, 134, 136, 137, 139, 141, 142, 144, 145, 147, 149, 150, 152, 153, 155, 157,
+    158, 160, 162, 163, 165, 167, 169, 170, 172, 174, 176, 177, 179, 181, 183, 185,
+    186, 188, 190, 192, 194, 196, 198, 200, 201, 203, 205, 207, 209, 211, 213, 215,
+    217, 219, 221, 223, 225, 227, 229, 231, 233, 235, 237, 240, 242, 244, 246, 248,
+};
+
+// ============================================================================
+// Engine State
+// ============================================================================
+
+typedef FastPin<UPS_STATUS_LED> StatusLedPin;      // SBI/CBI in the ISRs
+
+static volatile uint8_t ledPattern = LED_PATTERN_OFF;  // Written by the main loop
+
+// Owned by the Timer3 ISRs
+static uint8_t activePattern = LED_PATTERN_OFF;
+static uint8_t ledDuty = 0;
+static uint16_t patternMs = 0;
+static uint16_t fadePhase = 0;
+static bool stepPending = false;
+
+static inline bool isSocPattern(uint8_t pattern) {
+    return pattern <= 100;
+}
+
+// Advance the active pattern by one millisecond and compute the next duty
+static void stepPattern() {
+    uint8_t pattern = ledPattern;
+    uint16_t cycleMs = (pattern == LED_PATTERN_DISCONNECTED) ? LED_DISCONNECTED_CYCLE_MS : LED_CYCLE_MS;
+
+    if (pattern != activePattern) {
+        // Restart the cycle, except for SoC updates within the blink pattern
+        if (!(isSocPattern(pattern) && isSocPattern(activePattern))) {
+            patternMs = 0;
+            fadePhase = 0;
+        }
+        activePattern = pattern;
+    } else if (++patternMs >= cycleMs) {
+        patternMs = 0;
+    }
+
+    switch (pattern) {
+        case LED_PATTERN_CHARGING: {
+            // Triangle wave over the 16-bit phase: 0..255 up, then back down
+            fadePhase += LED_FADE_STEP;
+            uint16_t level = fadePhase >> 7;
+            if (level > 255) {
+                level = 511 - level;
+            }
+            ledDuty = pgm_read_byte(&LED_GAMMA[level]);
+            break;
+        }
+        case LED_PATTERN_DISCONNECTED:
+            ledDuty = (patternMs < LED_DISCONNECTED_CYCLE_MS / 2) ? LED_DUTY_MAX : 0;
+            break;
+        case LED_PATTERN_FLASH:
+            ledDuty = (patternMs < LED_FLASH_MS) ? LED_DUTY_MAX : 0;
+            break;
+        case LED_PATTERN_OFF:
+            ledDuty = 0;
+            break;
+        default:
+            // SoC blink: 1% = 50 ms of on-time per 5 s cycle
+            ledDuty = (isSocPattern(pattern) && patternMs < (uint16_t)pattern * (LED_CYCLE_MS / 100))
+                      ? LED_DUTY_MAX : 0;
+            break;
+    }
+}
+
+// Start of a PWM period
+ISR(TIMER3_COMPA_vect) {
+    stepPending = true;
+    if (ledDuty) {
+        StatusLedPin::high();
+    }
+}
+
+// End of the on-time. The next duty is computed here, well ahead of the next
+// period, so even a 1-tick duty is never missed because of ISR latency. If the
+// new OCR3B lies ahead of the counter this fires once more in the same period,
+// which stepPending turns into a no-op.
+ISR(TIMER3_COMPB_vect) {
+    PROFILE_BEGIN(PROF_ISR_LED);
+    StatusLedPin::low();
+    if (stepPending) {
+        stepPending = false;
+        stepPattern();
+        OCR3B = ledDuty;
+    }
+    PROFILE_END(PROF_ISR_LED);
+}
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void beginStatusLed() {
+    StatusLedPin::low();
+    StatusLedPin::output();
+
+    // Timer3: CTC on OCR3A, clk/64 -> 4 us per tick, 1 ms period
+    noInterrupts();
+    TCCR3A = 0;
+    TCCR3B = _BV(WGM32) | _BV(CS31) | _BV(CS30);
+    TCNT3 = 0;
+    OCR3A = LED_PWM_TOP;
+    OCR3B = 0;
+    TIFR3 = _BV(OCF3A) | _BV(OCF3B);
+    TIMSK3 = _BV(OCIE3A) | _BV(OCIE3B);
+    interrupts();
+}
+
+void setStatusLedPattern(uint8_t pattern) {
+    ledPattern = pattern;
+}
+
+uint8_t getStatusLedPattern() {
+    return ledPattern;
+}
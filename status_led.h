@@ -0,0 +1,40 @@
+#ifndef STATUS_LED_H
+#define STATUS_LED_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// Status LED Animation Engine
+// ============================================================================
+// LED patterns are generated entirely by Timer3 interrupts: a 1 kHz software
+// PWM on the LED pin whose duty cycle steps through a gamma-corrected PROGMEM
+// table. The main loop only selects the pattern by writing a single byte.
+// D13's hardware PWM (Timer4) is left free for instrumentation.
+
+// Pattern byte:
+//   0 - 100 : discharging, on-time per 5 s cycle proportional to SoC
+//   other   : one of the patterns below
+#define LED_PATTERN_CHARGING        0xF0    // Gamma-corrected fade in/out, 5 s cycle
+#define LED_PATTERN_DISCONNECTED    0xF1    // Fast blink, 500 ms on / 500 ms off
+#define LED_PATTERN_FLASH           0xF2    // 50 ms flash every 5 s
+#define LED_PATTERN_OFF             0xFF
+
+#define LED_PWM_TOP                 249     // Timer3 CTC top: 250 x 4 us = 1 ms period
+#define LED_DUTY_MAX                248     // Keep one tick off so COMPB never coincides with COMPA
+#define LED_CYCLE_MS                5000    // Charging fade and SoC blink cycle
+#define LED_DISCONNECTED_CYCLE_MS   1000
+#define LED_FLASH_MS                50
+#define LED_FADE_STEP               13      // 16-bit fade phase increment per ms (65536 / 13 ~ 5 s)
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Configure UPS_STATUS_LED and start Timer3
+void beginStatusLed();
+
+// Select the pattern (single byte write, safe to call at any time)
+void setStatusLedPattern(uint8_t pattern);
+uint8_t getStatusLedPattern();
+
+#endif // STATUS_LED_H
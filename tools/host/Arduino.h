@@ -0,0 +1,110 @@
+/*
+ * Arduino.h (host)
+ *
+ * Minimal Arduino API for building the gamepad processing code on a PC.
+ * Pins, ADC values and the clock are driven by the host program through
+ * host_arduino.h; HID reports are captured by the HID-Project.h stand-in.
+ */
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+
+// Leonardo analog pin numbers
+#define A0              18
+#define A1              19
+#define A2              20
+#define A3              21
+#define A4              22
+#define A5              23
+
+#define HOST_PIN_COUNT  32
+
+// Program memory is ordinary memory on the host
+#define PROGMEM
+#define PSTR(s)                 (s)
+#define F(s)                    (s)
+#define pgm_read_byte(addr)     (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)     ((uint16_t)(((const uint8_t*)(addr))[0] | (((const uint8_t*)(addr))[1] << 8)))
+#define pgm_read_dword(addr)    (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)      (*(const void* const*)(addr))
+#define memcpy_P                memcpy
+
+#define noInterrupts()
+#define interrupts()
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+template <typename T> T constrain(T x, T low, T high) {
+    return x < low ? low : (x > high ? high : x);
+}
+
+class String {
+public:
+    String(const char* s = "") : str(s) {}
+    const char* c_str() const { return str; }
+private:
+    const char* str;
+};
+
+// Text output on top of write(), like the Arduino core
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t len);
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+    size_t print(int value, int base = 10) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = 10) { return print((unsigned long)value, base); }
+    size_t print(double value, int digits = 2);
+    size_t println() { return print('\n'); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int base) { size_t n = print(value, base); return n + println(); }
+};
+
+// Serial output is discarded unless the host program enables echo
+class HostSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    operator bool() const { return true; }
+    int available() { return 0; }
+    int read() { return -1; }
+    int availableForWrite() { return 64; }
+    void flush() {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t len) override;
+    using Print::write;
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,81 @@
+/*
+ * HID-Project.h (host)
+ *
+ * Stand-in for NicoHood's HID-Project: the Keyboard and Mouse objects keep
+ * the same report state and send one report per API call, but the reports
+ * are handed to the host sink (host_arduino.h) instead of USB.
+ */
+#ifndef HOST_HID_PROJECT_H
+#define HOST_HID_PROJECT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Report IDs used by the LatteDeck composite device (usb_config.h)
+#define HOST_REPORT_ID_MOUSE        2
+#define HOST_REPORT_ID_KEYBOARD     3
+
+#define MOUSE_LEFT      (1 << 0)
+#define MOUSE_RIGHT     (1 << 1)
+#define MOUSE_MIDDLE    (1 << 2)
+#define MOUSE_PREV      (1 << 3)
+#define MOUSE_NEXT      (1 << 4)
+#define MOUSE_ALL       (MOUSE_LEFT | MOUSE_RIGHT | MOUSE_MIDDLE | MOUSE_PREV | MOUSE_NEXT)
+
+enum KeyboardKeycode : uint8_t {
+    KEY_RESERVED = 0x00,
+    KEY_A = 0x04, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M,
+    KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z,
+    KEY_1 = 0x1E, KEY_2, KEY_3, KEY_4, KEY_5, KEY_6, KEY_7, KEY_8, KEY_9, KEY_0,
+    KEY_ENTER = 0x28, KEY_ESC, KEY_BACKSPACE, KEY_TAB, KEY_SPACE,
+    KEY_F1 = 0x3A, KEY_F2, KEY_F3, KEY_F4, KEY_F5, KEY_F6, KEY_F7, KEY_F8, KEY_F9, KEY_F10, KEY_F11, KEY_F12,
+    KEY_RIGHT_ARROW = 0x4F, KEY_LEFT_ARROW, KEY_DOWN_ARROW, KEY_UP_ARROW,
+    KEY_LEFT_CTRL = 0xE0, KEY_LEFT_SHIFT, KEY_LEFT_ALT, KEY_LEFT_GUI,
+    KEY_RIGHT_CTRL, KEY_RIGHT_SHIFT, KEY_RIGHT_ALT, KEY_RIGHT_GUI
+};
+
+class Keyboard_ {
+public:
+    Keyboard_();
+    void begin() {}
+    void end() {}
+
+    // ASCII characters (US layout) and raw keycodes, like HID-Project
+    size_t press(uint8_t ascii);
+    size_t release(uint8_t ascii);
+    size_t press(KeyboardKeycode key);
+    size_t release(KeyboardKeycode key);
+    size_t write(uint8_t ascii);
+    void releaseAll();
+
+    // Change the report without sending, then send it once
+    bool add(KeyboardKeycode key);
+    bool remove(KeyboardKeycode key);
+    void send();
+
+private:
+    uint8_t modifiers;
+    uint8_t keys[6];
+};
+
+class Mouse_ {
+public:
+    Mouse_();
+    void begin() {}
+    void end() {}
+    void click(uint8_t b = MOUSE_LEFT);
+    void move(signed char x, signed char y, signed char wheel = 0);
+    void press(uint8_t b = MOUSE_LEFT);
+    void release(uint8_t b = MOUSE_LEFT);
+    void releaseAll();
+    bool isPressed(uint8_t b = MOUSE_LEFT);
+
+private:
+    void report(signed char x, signed char y, signed char wheel);
+    uint8_t buttons;
+};
+
+extern Keyboard_ Keyboard;
+extern Mouse_ Mouse;
+
+#endif // HOST_HID_PROJECT_H
@@ -0,0 +1,5 @@
+/*
+ * HID-Settings.h (host)
+ *
+ * Nothing to configure for the host build.
+ */
@@ -0,0 +1,28 @@
+/*
+ * HID.h (host)
+ *
+ * Stand-in for the Arduino core's PluggableUSB HID class: appended descriptors
+ * are collected (hostGetHidDescriptor()), reports are handed to the host sink
+ * (host_arduino.h).
+ */
+#ifndef HOST_HID_H
+#define HOST_HID_H
+
+#include <stdint.h>
+
+class HIDSubDescriptor {
+public:
+    HIDSubDescriptor(const void* d, uint16_t l) : data(d), length(l) {}
+    const void* data;
+    const uint16_t length;
+};
+
+class HID_ {
+public:
+    int AppendDescriptor(HIDSubDescriptor* node);
+    int SendReport(uint8_t id, const void* data, int len);
+};
+
+HID_& HID();
+
+#endif // HOST_HID_H
@@ -0,0 +1,323 @@
+/*
+ * host_arduino.cpp
+ *
+ * Implementation of the host Arduino environment and HID-Project stand-in.
+ */
+#include "Arduino.h"
+#include "HID-Project.h"
+#include "HID.h"
+#include "host_arduino.h"
+
+// ============================================================================
+// Simulated Hardware State
+// ============================================================================
+
+static uint64_t simMicros = 0;
+static int digitalLevels[HOST_PIN_COUNT];
+static int analogValues[HOST_PIN_COUNT];
+static bool digitalInitialized = false;
+
+#define HOST_HID_MAX_DESCRIPTORS    8
+
+static HostHidSink hidSink = nullptr;
+static void* hidSinkContext = nullptr;
+static bool serialEcho = false;
+
+HostSerial Serial;
+Keyboard_ Keyboard;
+Mouse_ Mouse;
+
+// Unconnected inputs read HIGH (all buttons use pull-ups)
+static void initDigital() {
+    if (!digitalInitialized) {
+        for (int i = 0; i < HOST_PIN_COUNT; i++) {
+            digitalLevels[i] = HIGH;
+        }
+        digitalInitialized = true;
+    }
+}
+
+// ============================================================================
+// Control Interface
+// ============================================================================
+
+void hostSetMicros(uint64_t us) { simMicros = us; }
+uint64_t hostMicros() { return simMicros; }
+
+void hostSetDigital(uint8_t pin, int level) {
+    initDigital();
+    if (pin < HOST_PIN_COUNT) digitalLevels[pin] = level;
+}
+
+void hostSetAnalog(uint8_t pin, int value) {
+    if (pin < HOST_PIN_COUNT) analogValues[pin] = value;
+}
+
+void hostSetHidSink(HostHidSink sink, void* context) {
+    hidSink = sink;
+    hidSinkContext = context;
+}
+
+void hostEmitHidReport(uint8_t reportId, const uint8_t* data, uint8_t length) {
+    if (!hidSink) {
+        return;
+    }
+    HostHidReport report;
+    report.timestampUs = simMicros;
+    report.reportId = reportId;
+    report.length = length <= sizeof(report.data) ? length : sizeof(report.data);
+    memcpy(report.data, data, report.length);
+    hidSink(report, hidSinkContext);
+}
+
+void hostSetSerialEcho(bool enabled) { serialEcho = enabled; }
+
+// ============================================================================
+// Arduino API
+// ============================================================================
+
+void pinMode(uint8_t, uint8_t) {}
+
+int digitalRead(uint8_t pin) {
+    initDigital();
+    return pin < HOST_PIN_COUNT ? digitalLevels[pin] : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) { hostSetDigital(pin, value); }
+
+int analogRead(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? analogValues[pin] : 0;
+}
+
+void analogWrite(uint8_t, int) {}
+
+unsigned long millis() { return (unsigned long)(simMicros / 1000); }
+unsigned long micros() { return (unsigned long)simMicros; }
+void delay(unsigned long ms) { simMicros += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { simMicros += us; }
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+size_t HostSerial::write(uint8_t c) {
+    if (serialEcho) fputc(c, stderr);
+    return 1;
+}
+
+size_t HostSerial::write(const uint8_t* buf, size_t len) {
+    if (serialEcho) fwrite(buf, 1, len, stderr);
+    return len;
+}
+
+size_t Print::write(const uint8_t* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        write(buf[i]);
+    }
+    return len;
+}
+
+size_t Print::print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+
+size_t Print::print(long value, int base) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%ld", value);
+    return print(buf);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%lu", value);
+    return print(buf);
+}
+
+size_t Print::print(double value, int digits) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", digits, value);
+    return print(buf);
+}
+
+// ============================================================================
+// Keyboard (HID-Project compatible report handling)
+// ============================================================================
+
+// US layout: ASCII to keycode, bit 7 = shift
+static uint8_t asciiToKeycode(uint8_t c) {
+    if (c >= 'a' && c <= 'z') return KEY_A + (c - 'a');
+    if (c >= 'A' && c <= 'Z') return 0x80 | (KEY_A + (c - 'A'));
+    if (c >= '1' && c <= '9') return KEY_1 + (c - '1');
+    if (c == '0') return KEY_0;
+    switch (c) {
+        case ' ':  return KEY_SPACE;
+        case '\t': return KEY_TAB;
+        case '\n': return KEY_ENTER;
+        case 0x1B: return KEY_ESC;
+        case 0x08: return KEY_BACKSPACE;
+        default:   return KEY_RESERVED;
+    }
+}
+
+Keyboard_::Keyboard_() : modifiers(0) {
+    memset(keys, 0, sizeof(keys));
+}
+
+bool Keyboard_::add(KeyboardKeycode key) {
+    if (key >= KEY_LEFT_CTRL) {
+        modifiers |= (uint8_t)(1 << (key - KEY_LEFT_CTRL));
+        return true;
+    }
+    if (key == KEY_RESERVED) {
+        return false;
+    }
+    for (int i = 0; i < 6; i++) {
+        if (keys[i] == key) return true;
+    }
+    for (int i = 0; i < 6; i++) {
+        if (keys[i] == 0) {
+            keys[i] = key;
+            return true;
+        }
+    }
+    return false;   // 6KRO rollover: key dropped
+}
+
+bool Keyboard_::remove(KeyboardKeycode key) {
+    if (key >= KEY_LEFT_CTRL) {
+        modifiers &= (uint8_t)~(1 << (key - KEY_LEFT_CTRL));
+        return true;
+    }
+    bool found = false;
+    for (int i = 0; i < 6; i++) {
+        if (key != KEY_RESERVED && keys[i] == key) {
+            keys[i] = 0;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Keyboard_::send() {
+    uint8_t report[8];
+    report[0] = modifiers;
+    report[1] = 0;
+    memcpy(&report[2], keys, sizeof(keys));
+    hostEmitHidReport(HOST_REPORT_ID_KEYBOARD, report, sizeof(report));
+}
+
+size_t Keyboard_::press(KeyboardKeycode key) {
+    bool ok = add(key);
+    send();
+    return ok ? 1 : 0;
+}
+
+size_t Keyboard_::release(KeyboardKeycode key) {
+    bool ok = remove(key);
+    send();
+    return ok ? 1 : 0;
+}
+
+size_t Keyboard_::press(uint8_t ascii) {
+    uint8_t code = asciiToKeycode(ascii);
+    if (code & 0x80) add(KEY_LEFT_SHIFT);
+    bool ok = add((KeyboardKeycode)(code & 0x7F));
+    send();
+    return ok ? 1 : 0;
+}
+
+size_t Keyboard_::release(uint8_t ascii) {
+    uint8_t code = asciiToKeycode(ascii);
+    if (code & 0x80) remove(KEY_LEFT_SHIFT);
+    bool ok = remove((KeyboardKeycode)(code & 0x7F));
+    send();
+    return ok ? 1 : 0;
+}
+
+size_t Keyboard_::write(uint8_t ascii) {
+    size_t n = press(ascii);
+    release(ascii);
+    return n;
+}
+
+void Keyboard_::releaseAll() {
+    modifiers = 0;
+    memset(keys, 0, sizeof(keys));
+    send();
+}
+
+// ============================================================================
+// HID (core PluggableUSB interface)
+// ============================================================================
+
+// Filled by static constructors (HIDSubDescriptor nodes), in link order like PluggableUSB
+static const HIDSubDescriptor* hidDescriptors[HOST_HID_MAX_DESCRIPTORS];
+static int hidDescriptorCount = 0;
+
+HID_& HID() {
+    static HID_ hid;
+    return hid;
+}
+
+int HID_::AppendDescriptor(HIDSubDescriptor* node) {
+    if (hidDescriptorCount >= HOST_HID_MAX_DESCRIPTORS) {
+        return 0;
+    }
+    hidDescriptors[hidDescriptorCount++] = node;
+    return 1;
+}
+
+size_t hostGetHidDescriptor(uint8_t* out, size_t size) {
+    size_t total = 0;
+    for (int i = 0; i < hidDescriptorCount; i++) {
+        total += hidDescriptors[i]->length;
+    }
+    if (total > size) {
+        return total;
+    }
+    size_t offset = 0;
+    for (int i = 0; i < hidDescriptorCount; i++) {
+        memcpy(out + offset, hidDescriptors[i]->data, hidDescriptors[i]->length);
+        offset += hidDescriptors[i]->length;
+    }
+    return total;
+}
+
+int HID_::SendReport(uint8_t id, const void* data, int len) {
+    hostEmitHidReport(id, static_cast<const uint8_t*>(data), (uint8_t)len);
+    return len;
+}
+
+// ============================================================================
+// Mouse
+// ============================================================================
+
+Mouse_::Mouse_() : buttons(0) {}
+
+void Mouse_::report(signed char x, signed char y, signed char wheel) {
+    uint8_t report[4] = { buttons, (uint8_t)x, (uint8_t)y, (uint8_t)wheel };
+    hostEmitHidReport(HOST_REPORT_ID_MOUSE, report, sizeof(report));
+}
+
+void Mouse_::click(uint8_t b) {
+    press(b);
+    release(b);
+}
+
+void Mouse_::move(signed char x, signed char y, signed char wheel) { report(x, y, wheel); }
+
+void Mouse_::press(uint8_t b) {
+    buttons |= b;
+    report(0, 0, 0);
+}
+
+void Mouse_::release(uint8_t b) {
+    buttons &= (uint8_t)~b;
+    report(0, 0, 0);
+}
+
+void Mouse_::releaseAll() {
+    buttons = 0;
+    report(0, 0, 0);
+}
+
+bool Mouse_::isPressed(uint8_t b) { return (buttons & b) != 0; }
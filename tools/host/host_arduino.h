@@ -0,0 +1,42 @@
+/*
+ * host_arduino.h
+ *
+ * Control side of the host Arduino environment: drive pins, ADC values and
+ * the simulated clock, and receive the HID reports the firmware code sends.
+ */
+#ifndef HOST_ARDUINO_CONTROL_H
+#define HOST_ARDUINO_CONTROL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// HID report as it would be sent over USB (report ID first)
+struct HostHidReport {
+    uint64_t timestampUs;   // Simulated time when the report was sent
+    uint8_t reportId;
+    uint8_t length;         // Payload length, excluding the report ID
+    uint8_t data[16];
+};
+
+typedef void (*HostHidSink)(const HostHidReport& report, void* context);
+
+// Simulated clock (delay() advances it)
+void hostSetMicros(uint64_t us);
+uint64_t hostMicros();
+
+// Pin and ADC levels seen by digitalRead()/analogRead()
+void hostSetDigital(uint8_t pin, int level);
+void hostSetAnalog(uint8_t pin, int value);
+
+// Every HID report is handed to the sink (none by default)
+void hostSetHidSink(HostHidSink sink, void* context);
+void hostEmitHidReport(uint8_t reportId, const uint8_t* data, uint8_t length);
+
+// Report descriptor of the composite device: every appended descriptor in
+// order. Returns the total length (nothing is copied if it exceeds size).
+size_t hostGetHidDescriptor(uint8_t* out, size_t size);
+
+// Echo firmware Serial output to stderr
+void hostSetSerialEcho(bool enabled);
+
+#endif // HOST_ARDUINO_CONTROL_H
@@ -0,0 +1,14 @@
+/*
+ * util/atomic.h (host)
+ *
+ * The host build is single threaded and has no interrupts, so atomic blocks
+ * just run their body once.
+ */
+#ifndef HOST_UTIL_ATOMIC_H
+#define HOST_UTIL_ATOMIC_H
+
+#define ATOMIC_RESTORESTATE         0
+#define ATOMIC_FORCEON              0
+#define ATOMIC_BLOCK(type)          for (int hostAtomicOnce = 1; hostAtomicOnce; hostAtomicOnce = 0)
+
+#endif // HOST_UTIL_ATOMIC_H
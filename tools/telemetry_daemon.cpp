@@ -0,0 +1,664 @@
+/*
+ * telemetry_daemon.cpp
+ *
+ * Collects the JSON status lines of many decks in one Linux process. Every
+ * serial port or pty given on the command line is read non-blocking from a
+ * single epoll loop; {"ups":...} and {"ups_power":...} reports are parsed in
+ * place (no allocation after start-up) into per-device rolling statistics. Ports that disappear
+ * (USB unplug, deck reset) are reopened once per second.
+ *
+ * Statistics are served on a Unix socket: each connection receives one JSON
+ * line per device followed by a {"daemon":...} summary line, then the socket
+ * is closed, e.g.
+ *   socat - UNIX-CONNECT:/tmp/latte-telemetry.sock
+ *
+ * Build:
+ *   g++ -std=c++11 -O2 -o telemetry_daemon tools/telemetry_daemon.cpp
+ *
+ * Usage:
+ *   telemetry_daemon [-s socket] [-q] device...
+ *     -s socket    Statistics socket (default: /tmp/latte-telemetry.sock)
+ *     -q           No per-device connect/disconnect messages on stderr
+ *
+ * See tools/telemetry_loadtest.cpp for the multi-device load test.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+
+#include <vector>
+
+#define DEFAULT_SOCKET_PATH     "/tmp/latte-telemetry.sock"
+#define LINE_MAX_LEN            256     // Longest firmware lines are the UPS reports (~190 bytes)
+#define READ_CHUNK              4096    // Bytes read per device and wake-up (keeps devices fair)
+#define ROLLING_WINDOW          64      // Samples kept per metric
+#define REOPEN_INTERVAL_MS      1000
+#define SNAPSHOT_LINE_MAX       1024    // Upper bound of one device line in the snapshot, without the path
+#define EPOLL_BATCH             64
+
+// ============================================================================
+// Rolling Statistics
+// ============================================================================
+
+struct RollingStat {
+    int32_t samples[ROLLING_WINDOW];
+    uint8_t head;
+    uint8_t count;
+    int64_t sum;
+
+    void add(int32_t value) {
+        if (count == ROLLING_WINDOW) {
+            sum -= samples[head];
+        } else {
+            count++;
+        }
+        samples[head] = value;
+        sum += value;
+        head = (head + 1) % ROLLING_WINDOW;
+    }
+
+    int32_t last() const {
+        return count ? samples[(head + ROLLING_WINDOW - 1) % ROLLING_WINDOW] : 0;
+    }
+
+    void range(int32_t& lo, int32_t& hi) const {
+        lo = hi = last();
+        for (uint8_t i = 0; i < count; i++) {
+            if (samples[i] < lo) lo = samples[i];
+            if (samples[i] > hi) hi = samples[i];
+        }
+    }
+};
+
+// ============================================================================
+// UPS Report Parsers
+// ============================================================================
+
+// Fields of {"ups":{...}} (see SimpleUPS::printStatus())
+struct UpsSample {
+    int32_t voltage_mV;
+    int32_t current_mA;
+    int32_t capacity_percent;
+    int32_t is_charging;
+    int32_t is_connected;
+    int32_t last_update_ms;
+    int32_t poll_us;
+    int32_t max_poll_us;
+    int32_t faults;
+};
+
+// Fields of {"ups_power":{...}} (see SimpleUPS::reportPowerStatus())
+struct PowerSample {
+    int32_t in_mW;
+    int32_t sys_mW;
+    int32_t bat_mW;
+    int32_t vsys_mV;
+    int32_t psys_mV;
+    int32_t in_avg_mW;
+    int32_t sys_avg_mW;
+    int32_t bat_avg_mW;
+    int32_t in_peak_mW;
+    int32_t sys_peak_mW;
+    int32_t dischg_peak_mW;
+    int32_t samples;
+};
+
+struct ReportField {
+    const char* name;
+    size_t offset;
+};
+
+static const ReportField upsFields[] = {
+    { "voltage_mV",       offsetof(UpsSample, voltage_mV) },
+    { "current_mA",       offsetof(UpsSample, current_mA) },
+    { "capacity_percent", offsetof(UpsSample, capacity_percent) },
+    { "is_charging",      offsetof(UpsSample, is_charging) },
+    { "is_connected",     offsetof(UpsSample, is_connected) },
+    { "last_update_ms",   offsetof(UpsSample, last_update_ms) },
+    { "poll_us",          offsetof(UpsSample, poll_us) },
+    { "max_poll_us",      offsetof(UpsSample, max_poll_us) },
+    { "faults",           offsetof(UpsSample, faults) },
+};
+
+static const ReportField powerFields[] = {
+    { "in_mW",            offsetof(PowerSample, in_mW) },
+    { "sys_mW",           offsetof(PowerSample, sys_mW) },
+    { "bat_mW",           offsetof(PowerSample, bat_mW) },
+    { "vsys_mV",          offsetof(PowerSample, vsys_mV) },
+    { "psys_mV",          offsetof(PowerSample, psys_mV) },
+    { "in_avg_mW",        offsetof(PowerSample, in_avg_mW) },
+    { "sys_avg_mW",       offsetof(PowerSample, sys_avg_mW) },
+    { "bat_avg_mW",       offsetof(PowerSample, bat_avg_mW) },
+    { "in_peak_mW",       offsetof(PowerSample, in_peak_mW) },
+    { "sys_peak_mW",      offsetof(PowerSample, sys_peak_mW) },
+    { "dischg_peak_mW",   offsetof(PowerSample, dischg_peak_mW) },
+    { "samples",          offsetof(PowerSample, samples) },
+};
+
+static bool startsWith(const char* s, const char* end, const char* prefix) {
+    size_t n = strlen(prefix);
+    return (size_t)(end - s) >= n && memcmp(s, prefix, n) == 0;
+}
+
+// Flat object of number/boolean values, parsed in place. Unknown keys are
+// skipped so newer firmware can add fields; anything else is a parse error.
+template <typename Sample, size_t N>
+static bool parseReport(const char* s, const char* end, const char* prefix,
+                        const ReportField (&fields)[N], Sample& out) {
+    if (!startsWith(s, end, prefix)) {
+        return false;
+    }
+    s += strlen(prefix);
+    memset(&out, 0, sizeof(out));
+
+    while (s < end) {
+        if (*s++ != '"') return false;
+        const char* key = s;
+        while (s < end && *s != '"') s++;
+        size_t keyLen = s - key;
+        if (s + 2 > end || s[1] != ':') return false;
+        s += 2;
+
+        int32_t value;
+        if (startsWith(s, end, "true")) {
+            value = 1;
+            s += 4;
+        } else if (startsWith(s, end, "false")) {
+            value = 0;
+            s += 5;
+        } else {
+            bool negative = s < end && *s == '-';
+            if (negative) s++;
+            if (s >= end || *s < '0' || *s > '9') return false;
+            int64_t v = 0;
+            while (s < end && *s >= '0' && *s <= '9') {
+                v = v * 10 + (*s++ - '0');
+            }
+            value = (int32_t)(negative ? -v : v);
+        }
+
+        for (const ReportField& field : fields) {
+            if (strlen(field.name) == keyLen && memcmp(field.name, key, keyLen) == 0) {
+                *reinterpret_cast<int32_t*>(reinterpret_cast<char*>(&out) + field.offset) = value;
+                break;
+            }
+        }
+
+        if (s < end && *s == ',') {
+            s++;
+        } else {
+            return startsWith(s, end, "}}");
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Devices
+// ============================================================================
+
+enum SourceKind : uint8_t {
+    SOURCE_DEVICE,
+    SOURCE_LISTEN,
+    SOURCE_TIMER,
+    SOURCE_SIGNAL
+};
+
+// epoll user data: every registered fd points at one of these
+struct Source {
+    SourceKind kind;
+    int fd;
+};
+
+struct Device {
+    Source source;
+    const char* path;
+    char* jsonPath;                 // path escaped for a JSON string
+    bool connected;
+
+    char line[LINE_MAX_LEN];
+    size_t lineLen;
+    bool lineOverflow;              // Discarding the rest of an overlong line
+
+    uint64_t bytes;
+    uint64_t lines;
+    uint64_t reports;               // {"ups":...}
+    uint64_t faultEvents;           // {"ups_fault":...}
+    uint64_t powerReports;          // {"ups_power":...}
+    uint64_t parseErrors;
+    uint64_t overlong;
+    uint32_t reconnects;
+    uint64_t lastReportMs;
+
+    UpsSample last;
+    RollingStat voltage;
+    RollingStat current;
+    RollingStat capacity;
+    RollingStat pollUs;
+
+    PowerSample power;
+    RollingStat inputPower;
+    RollingStat systemPower;
+    RollingStat batteryPower;
+};
+
+struct Daemon {
+    int epollFd;
+    const char* socketPath;
+    bool quiet;
+    Source listen;
+    Source timer;
+    Source signals;
+    std::vector<Device> devices;
+    std::vector<char> snapshot;     // Sized once for all devices
+    uint64_t startMs;
+    uint64_t wakeups;
+    uint64_t queries;
+};
+
+static uint64_t monotonicMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static bool watch(Daemon& daemon, Source& source) {
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = &source;
+    return epoll_ctl(daemon.epollFd, EPOLL_CTL_ADD, source.fd, &ev) == 0;
+}
+
+static void openDevice(Daemon& daemon, Device& device) {
+    int fd = open(device.path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+
+    // Raw bytes: no echo back to the deck, no line editing. CDC ACM ignores the baud rate.
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    device.source.fd = fd;
+    if (!watch(daemon, device.source)) {
+        close(fd);
+        device.source.fd = -1;
+        return;
+    }
+    device.connected = true;
+    device.lineLen = 0;
+    device.lineOverflow = false;
+    if (!daemon.quiet) {
+        fprintf(stderr, "telemetry: %s connected\n", device.path);
+    }
+}
+
+static void closeDevice(Daemon& daemon, Device& device) {
+    epoll_ctl(daemon.epollFd, EPOLL_CTL_DEL, device.source.fd, nullptr);
+    close(device.source.fd);
+    device.source.fd = -1;
+    device.connected = false;
+    device.reconnects++;
+    if (!daemon.quiet) {
+        fprintf(stderr, "telemetry: %s disconnected\n", device.path);
+    }
+}
+
+static void handleLine(Device& device, const char* s, const char* end) {
+    device.lines++;
+    if (startsWith(s, end, "{\"ups\":")) {
+        UpsSample sample;
+        if (!parseReport(s, end, "{\"ups\":{", upsFields, sample)) {
+            device.parseErrors++;
+            return;
+        }
+        device.reports++;
+        device.lastReportMs = monotonicMs();
+        device.last = sample;
+        device.voltage.add(sample.voltage_mV);
+        device.current.add(sample.current_mA);
+        device.capacity.add(sample.capacity_percent);
+        device.pollUs.add(sample.poll_us);
+    } else if (startsWith(s, end, "{\"ups_power\":")) {
+        PowerSample sample;
+        if (!parseReport(s, end, "{\"ups_power\":{", powerFields, sample)) {
+            device.parseErrors++;
+            return;
+        }
+        device.powerReports++;
+        device.power = sample;
+        device.inputPower.add(sample.in_mW);
+        device.systemPower.add(sample.sys_mW);
+        device.batteryPower.add(sample.bat_mW);
+    } else if (startsWith(s, end, "{\"ups_fault\":")) {
+        device.faultEvents++;
+    }
+}
+
+static void readDevice(Daemon& daemon, Device& device) {
+    char chunk[READ_CHUNK];
+    ssize_t n = read(device.source.fd, chunk, sizeof(chunk));
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return;
+    }
+    if (n <= 0) {
+        // EOF, or EIO once the other side of a pty or the USB device is gone
+        closeDevice(daemon, device);
+        return;
+    }
+    device.bytes += n;
+
+    for (ssize_t i = 0; i < n; i++) {
+        char c = chunk[i];
+        if (c == '\n') {
+            if (device.lineOverflow) {
+                device.overlong++;
+            } else {
+                size_t len = device.lineLen;
+                if (len && device.line[len - 1] == '\r') len--;
+                handleLine(device, device.line, device.line + len);
+            }
+            device.lineLen = 0;
+            device.lineOverflow = false;
+        } else if (device.lineLen < LINE_MAX_LEN) {
+            device.line[device.lineLen++] = c;
+        } else {
+            device.lineOverflow = true;
+        }
+    }
+}
+
+// ============================================================================
+// Statistics Socket
+// ============================================================================
+
+// New length after snprintf() returned n at len. A truncated write stops at
+// the last byte (snprintf's terminator), so size - len never underflows.
+static size_t advance(size_t len, int n, size_t size) {
+    if (n < 0 || size == 0) {
+        return len;
+    }
+    return len + (size_t)n < size ? len + n : size - 1;
+}
+
+static size_t appendStat(char* out, size_t size, size_t len, const char* name, const RollingStat& stat) {
+    int32_t lo, hi;
+    stat.range(lo, hi);
+    int n = snprintf(out + len, size - len, ",\"%s\":{\"last\":%d,\"min\":%d,\"avg\":%lld,\"max\":%d}",
+                     name, stat.last(), lo, stat.count ? (long long)(stat.sum / stat.count) : 0LL, hi);
+    return advance(len, n, size);
+}
+
+// Device paths come from the command line; escape them once at start-up
+static char* escapeJson(const char* in) {
+    char* out = (char*)malloc(strlen(in) * 6 + 1);
+    char* o = out;
+    for (const unsigned char* c = (const unsigned char*)in; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            *o++ = '\\';
+            *o++ = *c;
+        } else if (*c < 0x20) {
+            o += sprintf(o, "\\u%04x", *c);
+        } else {
+            *o++ = *c;
+        }
+    }
+    *o = '\0';
+    return out;
+}
+
+static size_t formatDevice(const Device& device, uint64_t nowMs, char* out, size_t size) {
+    int n = snprintf(out, size,
+        "{\"device\":{\"path\":\"%s\",\"connected\":%s,\"bytes\":%llu,\"lines\":%llu,\"reports\":%llu,"
+        "\"fault_events\":%llu,\"parse_errors\":%llu,\"overlong\":%llu,\"reconnects\":%u,\"age_ms\":%lld,"
+        "\"is_charging\":%s,\"ups_connected\":%s,\"faults\":%d",
+        device.jsonPath, device.connected ? "true" : "false",
+        (unsigned long long)device.bytes, (unsigned long long)device.lines,
+        (unsigned long long)device.reports, (unsigned long long)device.faultEvents,
+        (unsigned long long)device.parseErrors, (unsigned long long)device.overlong,
+        device.reconnects, device.reports ? (long long)(nowMs - device.lastReportMs) : -1LL,
+        device.last.is_charging ? "true" : "false", device.last.is_connected ? "true" : "false",
+        device.last.faults);
+    size_t len = advance(0, n, size);
+    len = appendStat(out, size, len, "voltage_mV", device.voltage);
+    len = appendStat(out, size, len, "current_mA", device.current);
+    len = appendStat(out, size, len, "capacity_percent", device.capacity);
+    len = appendStat(out, size, len, "poll_us", device.pollUs);
+
+    // Power budget: the firmware's own averages and peaks, plus the rolling window of samples
+    n = snprintf(out + len, size - len,
+        ",\"power_reports\":%llu,\"sys_avg_mW\":%d,\"sys_peak_mW\":%d,\"dischg_peak_mW\":%d",
+        (unsigned long long)device.powerReports, device.power.sys_avg_mW, device.power.sys_peak_mW,
+        device.power.dischg_peak_mW);
+    len = advance(len, n, size);
+    len = appendStat(out, size, len, "in_mW", device.inputPower);
+    len = appendStat(out, size, len, "sys_mW", device.systemPower);
+    len = appendStat(out, size, len, "bat_mW", device.batteryPower);
+    return advance(len, snprintf(out + len, size - len, "}}\n"), size);
+}
+
+static size_t formatSummary(const Daemon& daemon, uint64_t nowMs, char* out, size_t size) {
+    uint64_t lines = 0, reports = 0;
+    unsigned connected = 0;
+    for (const Device& device : daemon.devices) {
+        lines += device.lines;
+        reports += device.reports;
+        connected += device.connected;
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    uint64_t cpuUs = (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+                   + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+
+    int n = snprintf(out, size,
+        "{\"daemon\":{\"devices\":%zu,\"connected\":%u,\"lines\":%llu,\"reports\":%llu,"
+        "\"wakeups\":%llu,\"queries\":%llu,\"uptime_ms\":%llu,\"cpu_us\":%llu}}\n",
+        daemon.devices.size(), connected, (unsigned long long)lines, (unsigned long long)reports,
+        (unsigned long long)daemon.wakeups, (unsigned long long)daemon.queries,
+        (unsigned long long)(nowMs - daemon.startMs), (unsigned long long)cpuUs);
+    return advance(0, n, size);
+}
+
+// One snapshot per connection. The client is local and only reads, so a
+// bounded blocking send is simpler than tracking partial writes.
+static void serveQuery(Daemon& daemon) {
+    int client = accept4(daemon.listen.fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+        return;
+    }
+    daemon.queries++;
+
+    struct timeval timeout = { 0, 200000 };
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    uint64_t nowMs = monotonicMs();
+    char* out = daemon.snapshot.data();
+    size_t size = daemon.snapshot.size();
+    size_t len = 0;
+    for (const Device& device : daemon.devices) {
+        len += formatDevice(device, nowMs, out + len, size - len);
+    }
+    len += formatSummary(daemon, nowMs, out + len, size - len);
+
+    for (size_t sent = 0; sent < len; ) {
+        ssize_t n = send(client, out + sent, len - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += n;
+    }
+    close(client);
+}
+
+static int openListenSocket(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static void raiseFileLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int main(int argc, char** argv) {
+    Daemon daemon;
+    daemon.socketPath = DEFAULT_SOCKET_PATH;
+    daemon.quiet = false;
+    daemon.wakeups = 0;
+    daemon.queries = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:q")) != -1) {
+        switch (opt) {
+            case 's': daemon.socketPath = optarg; break;
+            case 'q': daemon.quiet = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-s socket] [-q] device...\n", argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-s socket] [-q] device...\n", argv[0]);
+        return 1;
+    }
+
+    raiseFileLimit();
+
+    // Everything is sized here; the event loop does not allocate
+    daemon.devices.resize(argc - optind);
+    size_t snapshotSize = SNAPSHOT_LINE_MAX;
+    for (size_t i = 0; i < daemon.devices.size(); i++) {
+        Device& device = daemon.devices[i];
+        memset(&device, 0, sizeof(device));
+        device.source.kind = SOURCE_DEVICE;
+        device.source.fd = -1;
+        device.path = argv[optind + i];
+        device.jsonPath = escapeJson(device.path);
+        snapshotSize += SNAPSHOT_LINE_MAX + strlen(device.jsonPath);
+    }
+    daemon.snapshot.resize(snapshotSize);
+
+    daemon.epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    daemon.listen.kind = SOURCE_LISTEN;
+    daemon.listen.fd = openListenSocket(daemon.socketPath);
+    if (daemon.listen.fd < 0) {
+        fprintf(stderr, "telemetry: cannot listen on %s: %s\n", daemon.socketPath, strerror(errno));
+        return 1;
+    }
+
+    daemon.timer.kind = SOURCE_TIMER;
+    daemon.timer.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec period;
+    period.it_interval.tv_sec = REOPEN_INTERVAL_MS / 1000;
+    period.it_interval.tv_nsec = (REOPEN_INTERVAL_MS % 1000) * 1000000L;
+    period.it_value = period.it_interval;
+    timerfd_settime(daemon.timer.fd, 0, &period, nullptr);
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    daemon.signals.kind = SOURCE_SIGNAL;
+    daemon.signals.fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    watch(daemon, daemon.listen);
+    watch(daemon, daemon.timer);
+    watch(daemon, daemon.signals);
+
+    daemon.startMs = monotonicMs();
+    for (Device& device : daemon.devices) {
+        openDevice(daemon, device);
+    }
+
+    bool running = true;
+    struct epoll_event events[EPOLL_BATCH];
+    while (running) {
+        int count = epoll_wait(daemon.epollFd, events, EPOLL_BATCH, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        daemon.wakeups++;
+
+        for (int i = 0; i < count; i++) {
+            Source* source = static_cast<Source*>(events[i].data.ptr);
+            switch (source->kind) {
+                case SOURCE_DEVICE: {
+                    // Source is the first member of Device
+                    Device& device = *reinterpret_cast<Device*>(source);
+                    if (device.connected) {
+                        readDevice(daemon, device);
+                    }
+                    break;
+                }
+                case SOURCE_LISTEN:
+                    serveQuery(daemon);
+                    break;
+                case SOURCE_TIMER: {
+                    uint64_t expirations;
+                    if (read(daemon.timer.fd, &expirations, sizeof(expirations)) > 0) {
+                        for (Device& device : daemon.devices) {
+                            if (!device.connected) openDevice(daemon, device);
+                        }
+                    }
+                    break;
+                }
+                case SOURCE_SIGNAL:
+                    running = false;
+                    break;
+            }
+        }
+    }
+
+    char summary[SNAPSHOT_LINE_MAX];
+    formatSummary(daemon, monotonicMs(), summary, sizeof(summary));
+    fputs(summary, stderr);
+
+    for (Device& device : daemon.devices) {
+        free(device.jsonPath);
+    }
+    unlink(daemon.socketPath);
+    return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * telemetry_loadtest.cpp
+ *
+ * Load test for telemetry_daemon: creates many virtual decks as pseudo
+ * terminals, starts the daemon on their slave ends and writes firmware-format
+ * {"ups":...} lines into the masters at a fixed rate per device. At the end
+ * the daemon's statistics socket is queried and every device's report count is
+ * compared with what was sent, and the daemon's CPU time is reported. The
+ * daemon is single-threaded, so the CPU figure is the share of one core.
+ *
+ * Build:
+ *   g++ -std=c++11 -O2 -o telemetry_loadtest tools/telemetry_loadtest.cpp
+ *
+ * Usage:
+ *   telemetry_loadtest [-n devices] [-r lines/s per device] [-d seconds] [-s socket] daemon
+ *     -n devices   Virtual decks (default: 256)
+ *     -r rate      UPS reports per second and device (default: 20; the firmware sends one per 3 s)
+ *     -d seconds   Test duration (default: 10)
+ *     -s socket    Statistics socket passed to the daemon (default: /tmp/latte-loadtest.sock)
+ *     daemon       Path of the telemetry_daemon binary
+ *
+ * Exit status is 0 when every sent report was counted by the daemon.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include <string>
+#include <vector>
+
+#define DEFAULT_SOCKET_PATH     "/tmp/latte-loadtest.sock"
+#define TICK_US                 1000    // Sender pacing
+#define DRAIN_MS                500     // Time for the daemon to catch up after the last line
+
+struct VirtualDeck {
+    int master;
+    std::string slavePath;
+    uint64_t nextDueUs;
+    uint64_t sent;
+    uint64_t stalls;                // Writes refused because the pty buffer was full
+    int32_t voltage_mV;
+    int32_t capacity;
+};
+
+static uint64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static bool openVirtualDeck(VirtualDeck& deck) {
+    deck.master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (deck.master < 0 || grantpt(deck.master) < 0 || unlockpt(deck.master) < 0) {
+        return false;
+    }
+    deck.slavePath = ptsname(deck.master);
+
+    // Raw mode before the daemon opens it, so no line is echoed or edited in between
+    int slave = open(deck.slavePath.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (slave < 0) {
+        return false;
+    }
+    struct termios tio;
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+    close(slave);
+    return true;
+}
+
+// Same fields and order as SimpleUPS::printStatus()
+static int formatUpsLine(VirtualDeck& deck, uint64_t nowUs, char* out, size_t size) {
+    deck.voltage_mV += (deck.sent & 1) ? 8 : -8;
+    return snprintf(out, size,
+        "{\"ups\":{\"voltage_mV\":%d,\"current_mA\":%d,\"capacity_percent\":%d,\"is_charging\":%s,"
+        "\"is_connected\":true,\"last_update_ms\":%llu,\"poll_us\":%u,\"max_poll_us\":%u,\"faults\":0}}\r\n",
+        deck.voltage_mV, (deck.sent & 1) ? -640 : 512, deck.capacity, (deck.sent & 1) ? "false" : "true",
+        (unsigned long long)(nowUs / 1000), 1100 + (unsigned)(deck.sent % 200), 1900u);
+}
+
+static int connectSocket(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        return fd;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return -1;
+}
+
+static std::string querySnapshot(const char* path) {
+    std::string snapshot;
+    int fd = connectSocket(path);
+    if (fd < 0) {
+        return snapshot;
+    }
+    char buf[65536];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        snapshot.append(buf, n);
+    }
+    close(fd);
+    return snapshot;
+}
+
+// Value of "key":<number> in the snapshot line that starts at pos
+static long long lineValue(const std::string& snapshot, size_t pos, const char* key) {
+    size_t end = snapshot.find('\n', pos);
+    size_t at = snapshot.find(key, pos);
+    if (at == std::string::npos || at > end) {
+        return -1;
+    }
+    return atoll(snapshot.c_str() + at + strlen(key));
+}
+
+static void raiseFileLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned deviceCount = 256;
+    unsigned rate = 20;
+    unsigned seconds = 10;
+    const char* socketPath = DEFAULT_SOCKET_PATH;
+
+    int opt;
+    bool bad = false;
+    while ((opt = getopt(argc, argv, "n:r:d:s:")) != -1) {
+        switch (opt) {
+            case 'n': deviceCount = atoi(optarg); break;
+            case 'r': rate = atoi(optarg); break;
+            case 'd': seconds = atoi(optarg); break;
+            case 's': socketPath = optarg; break;
+            default: bad = true; break;
+        }
+    }
+    if (bad || optind != argc - 1 || deviceCount == 0 || rate == 0) {
+        fprintf(stderr, "usage: %s [-n devices] [-r rate] [-d seconds] [-s socket] daemon\n", argv[0]);
+        return 1;
+    }
+    const char* daemonPath = argv[optind];
+
+    raiseFileLimit();
+
+    std::vector<VirtualDeck> decks(deviceCount);
+    uint64_t intervalUs = 1000000 / rate;
+    for (unsigned i = 0; i < deviceCount; i++) {
+        VirtualDeck& deck = decks[i];
+        if (!openVirtualDeck(deck)) {
+            fprintf(stderr, "loadtest: cannot create pty %u: %s\n", i, strerror(errno));
+            return 1;
+        }
+        deck.sent = 0;
+        deck.stalls = 0;
+        deck.voltage_mV = 7400 + (i % 64) * 10;
+        deck.capacity = 20 + i % 80;
+    }
+
+    // Start the daemon on all slave ends
+    std::vector<char*> daemonArgs;
+    daemonArgs.push_back(const_cast<char*>(daemonPath));
+    daemonArgs.push_back(const_cast<char*>("-q"));
+    daemonArgs.push_back(const_cast<char*>("-s"));
+    daemonArgs.push_back(const_cast<char*>(socketPath));
+    for (VirtualDeck& deck : decks) {
+        daemonArgs.push_back(const_cast<char*>(deck.slavePath.c_str()));
+    }
+    daemonArgs.push_back(nullptr);
+
+    pid_t daemon = fork();
+    if (daemon == 0) {
+        execv(daemonPath, daemonArgs.data());
+        perror("loadtest: execv");
+        _exit(127);
+    }
+
+    int probe = -1;
+    for (int i = 0; i < 200 && probe < 0; i++) {
+        usleep(10000);
+        probe = connectSocket(socketPath);
+    }
+    if (probe < 0) {
+        fprintf(stderr, "loadtest: daemon did not open %s\n", socketPath);
+        kill(daemon, SIGTERM);
+        return 1;
+    }
+    close(probe);
+    usleep(100000);     // Let the daemon finish opening the ptys
+
+    // Spread the devices evenly over one interval
+    uint64_t start = monotonicUs();
+    for (unsigned i = 0; i < deviceCount; i++) {
+        decks[i].nextDueUs = start + intervalUs * i / deviceCount;
+    }
+
+    uint64_t end = start + (uint64_t)seconds * 1000000;
+    uint64_t now = start;
+    char line[256];
+    while (now < end) {
+        for (VirtualDeck& deck : decks) {
+            while (deck.nextDueUs <= now && deck.nextDueUs < end) {
+                int len = formatUpsLine(deck, now, line, sizeof(line));
+                ssize_t n = write(deck.master, line, len);
+                if (n == len) {
+                    deck.sent++;
+                    deck.nextDueUs += intervalUs;
+                } else {
+                    // Buffer full: the daemon is behind, retry on the next tick
+                    deck.stalls++;
+                    break;
+                }
+            }
+        }
+        usleep(TICK_US);
+        now = monotonicUs();
+    }
+    double elapsed = (monotonicUs() - start) / 1e6;
+
+    usleep(DRAIN_MS * 1000);
+    std::string snapshot = querySnapshot(socketPath);
+
+    // Compare per-device counts with what was sent
+    uint64_t sent = 0, received = 0, stalls = 0;
+    unsigned short_devices = 0;
+    for (VirtualDeck& deck : decks) {
+        sent += deck.sent;
+        stalls += deck.stalls;
+        std::string key = "\"path\":\"" + deck.slavePath + "\"";
+        size_t pos = snapshot.find(key);
+        long long reports = pos == std::string::npos ? -1 : lineValue(snapshot, pos, "\"reports\":");
+        long long errors = pos == std::string::npos ? -1 : lineValue(snapshot, pos, "\"parse_errors\":");
+        if (reports != (long long)deck.sent || errors != 0) {
+            short_devices++;
+            if (short_devices <= 5) {
+                fprintf(stderr, "loadtest: %s sent %llu, daemon counted %lld (parse errors %lld)\n",
+                        deck.slavePath.c_str(), (unsigned long long)deck.sent, reports, errors);
+            }
+        }
+        if (reports > 0) {
+            received += reports;
+        }
+    }
+
+    kill(daemon, SIGTERM);
+    int status;
+    struct rusage usage;
+    wait4(daemon, &status, 0, &usage);
+    double cpu = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+               + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+
+    for (VirtualDeck& deck : decks) {
+        close(deck.master);
+    }
+    unlink(socketPath);
+
+    printf("{\"loadtest\":{\"devices\":%u,\"rate\":%u,\"seconds\":%.3f,\"sent\":%llu,\"received\":%llu,"
+           "\"lines_per_s\":%.0f,\"sender_stalls\":%llu,\"mismatched_devices\":%u,"
+           "\"daemon_cpu_s\":%.3f,\"daemon_core_percent\":%.1f}}\n",
+           deviceCount, rate, elapsed, (unsigned long long)sent, (unsigned long long)received,
+           sent / elapsed, (unsigned long long)stalls, short_devices,
+           cpu, 100.0 * cpu / (elapsed + DRAIN_MS / 1000.0));
+
+    return short_devices == 0 ? 0 : 1;
+}
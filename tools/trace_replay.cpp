@@ -0,0 +1,223 @@
+/*
+ * trace_replay.cpp
+ *
+ * Replays input traces recorded with ENABLE_INPUT_TRACE through the firmware's
+ * own joystick code (processJoystickFrame(), mapInputEvent())
+ * and prints the HID report sequence the device would have sent. Frames are
+ * processed back to back, so large trace corpora replay far faster than real
+ * time and can be diffed between firmware revisions.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -I tools/host -I . -o trace_replay \
+ *       tools/trace_replay.cpp tools/host/host_arduino.cpp gamepad_utils.cpp macros.cpp \
+ *       input_map.cpp key_pulse.cpp tunables.cpp hires_mouse.cpp nkro_keyboard.cpp turbo.cpp
+ *
+ * Usage:
+ *   trace_replay [-q] [capture.log]
+ *     capture.log  Raw serial capture; lines that are not trace lines are ignored
+ *                  (default: stdin)
+ *     -q           Print only the summary, not the reports
+ *
+ * Output, one line per HID report:
+ *   <timestamp_us> <report id> <payload bytes in hex>
+ *
+ * Note: AVR evaluates double as 32-bit float, the host uses 64-bit double, so
+ * mouse deltas can differ by one count where a value lands on a boundary.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "host_arduino.h"
+#include "gamepad_utils.h"
+#include "input_events.h"
+#include "perf_governor.h"
+#include "macros.h"
+#include "input_map.h"
+#include "key_pulse.h"
+#include "tunables.h"
+#include "nkro_keyboard.h"
+#include "turbo.h"
+
+// ============================================================================
+// Replay State
+// ============================================================================
+
+struct ReplayState {
+    JoystickData left;
+    JoystickData right;
+    GamepadFrameBuffer gamepad;
+    uint16_t buttons;
+    uint16_t reportIntervalUs;
+    bool haveHeader;
+
+    // 32-bit device timestamps extended to 64 bits
+    uint32_t lastRawTs;
+    uint64_t tsHigh;
+    uint64_t firstTs;
+    uint64_t lastTs;
+    uint64_t nextTickUs;            // Next 1.024 ms input tick (Timer0 compare A)
+
+    uint64_t frames;
+    uint64_t reports;
+    bool quiet;
+};
+
+static void printReport(const HostHidReport& report, void* context) {
+    ReplayState* state = static_cast<ReplayState*>(context);
+    state->reports++;
+    if (state->quiet) {
+        return;
+    }
+    printf("%llu %u", (unsigned long long)report.timestampUs, report.reportId);
+    for (uint8_t i = 0; i < report.length; i++) {
+        printf(" %02x", report.data[i]);
+    }
+    putchar('\n');
+}
+
+// ============================================================================
+// Trace Line Handling
+// ============================================================================
+
+static void applyHeader(ReplayState& state, const char* line) {
+    int lx, ly, rx, ry;
+    unsigned int reportUs;
+    if (sscanf(line, "#trace v1 zero %d %d %d %d report_us %u", &lx, &ly, &rx, &ry, &reportUs) != 5) {
+        return;
+    }
+    state.left.xZero = lx;
+    state.left.yZero = ly;
+    state.right.xZero = rx;
+    state.right.yZero = ry;
+    state.reportIntervalUs = (uint16_t)reportUs;
+    state.haveHeader = true;
+}
+
+// Turn level changes into the edge events the capture ISRs would have queued
+static void applyButtons(ReplayState& state, uint16_t buttons, uint32_t timestampUs) {
+    uint16_t changed = buttons ^ state.buttons;
+    state.buttons = buttons;
+
+    InputEvent event;
+    event.timestampUs = timestampUs;
+    for (uint8_t source = 0; source < INPUT_SRC_COUNT; source++) {
+        if (changed & INPUT_BIT(source)) {
+            event.source = source;
+            event.pressed = (buttons & INPUT_BIT(source)) != 0;
+            mapInputEvent(event);
+        }
+    }
+    loopInputMap(timestampUs);
+}
+
+static void applyFrame(ReplayState& state, const char* line) {
+    unsigned int ts, lx, ly, rx, ry, buttons;
+    if (!state.haveHeader ||
+        sscanf(line, "@%x,%x,%x,%x,%x,%x", &ts, &lx, &ly, &rx, &ry, &buttons) != 6) {
+        return;
+    }
+
+    if (state.frames > 0 && ts < state.lastRawTs) {
+        state.tsHigh += 0x100000000ULL;
+    }
+    state.lastRawTs = ts;
+    uint64_t now = state.tsHigh | ts;
+    if (state.frames == 0) {
+        state.firstTs = now;
+    }
+    state.lastTs = now;
+    hostSetMicros(now);
+
+    // Same order as loopGamepad(): sample, button edges, report frame. The
+    // traced readings are the frame's samples
+    GamepadFrame& frame = state.gamepad.next();
+    frame.timestampUs = ts;
+    frame.raw[FRAME_AXIS_LX] = (int16_t)lx;
+    frame.raw[FRAME_AXIS_LY] = (int16_t)ly;
+    frame.raw[FRAME_AXIS_RX] = (int16_t)rx;
+    frame.raw[FRAME_AXIS_RY] = (int16_t)ry;
+    frame.inputs = (uint16_t)buttons;
+
+    applyButtons(state, (uint16_t)buttons, ts);
+    loopMacros(millis());
+
+    // Run the input ticks that elapsed since the previous frame
+    if (state.frames == 0) {
+        state.nextTickUs = now;
+    }
+    while (state.nextTickUs <= now) {
+        #if KEY_PWM_ENABLED
+        keyPulseTick();
+        #endif
+        turboTick();
+        state.nextTickUs += TURBO_TICK_US;
+    }
+    #if KEY_PWM_ENABLED
+    applyKeyPulses();
+    #endif
+
+    int sensitivity = scaleMouseSensitivity(tunables.mouseSensitivity, state.reportIntervalUs,
+                                            PERF_BASE_REPORT_INTERVAL_US);
+    processJoystickFrame(state.gamepad.previous(), frame, state.left, state.right, sensitivity);
+    applyTurbo();
+    flushGamepadKeyboard();
+    state.gamepad.commit();
+
+    state.frames++;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    ReplayState state;
+    memset(&state, 0, sizeof(state));
+
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0) {
+            state.quiet = true;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    FILE* in = path ? fopen(path, "r") : stdin;
+    if (!in) {
+        fprintf(stderr, "trace_replay: cannot open %s\n", path);
+        return 1;
+    }
+
+    initializeJoystick(state.left, PIN_JOYSTICK_L_X, PIN_JOYSTICK_L_Y, PIN_JOYSTICK_L_SEL);
+    initializeJoystick(state.right, PIN_JOYSTICK_R_X, PIN_JOYSTICK_R_Y, PIN_JOYSTICK_R_SEL);
+    setupInputMap();
+    hostSetHidSink(printReport, &state);
+
+    auto start = std::chrono::steady_clock::now();
+
+    char line[256];
+    while (fgets(line, sizeof(line), in)) {
+        if (line[0] == '@') {
+            applyFrame(state, line);
+        } else if (line[0] == '#') {
+            applyHeader(state, line);
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double traced = state.frames ? (state.lastTs - state.firstTs) / 1e6 : 0.0;
+
+    fprintf(stderr, "frames: %llu, reports: %llu, trace: %.3f s, replay: %.6f s",
+            (unsigned long long)state.frames, (unsigned long long)state.reports, traced, elapsed);
+    if (elapsed > 0) {
+        fprintf(stderr, " (%.0f frames/s, %.0fx real time)", state.frames / elapsed, traced / elapsed);
+    }
+    fputc('\n', stderr);
+
+    if (in != stdin) {
+        fclose(in);
+    }
+    return 0;
+}
@@ -0,0 +1,488 @@
+/*
+ * uhid_bridge.cpp
+ *
+ * Presents the host-built firmware to Linux as a real HID device. The report
+ * descriptors the firmware appends (hires_mouse.cpp, nkro_keyboard.cpp) are
+ * registered through /dev/uhid, so the kernel's HID parser validates them and
+ * applications see an ordinary keyboard and mouse. The firmware's report path
+ * (mapInputEvent(), processJoystickFrame(), the NKRO flush) then runs in real
+ * time and every report it sends is forwarded to the virtual device.
+ *
+ * Each probe injects one simulated input (a press or release of the left
+ * stick button, or a right-stick deflection), runs one report frame and waits
+ * for the resulting evdev event. The evdev timestamp (CLOCK_MONOTONIC) is compared with the time
+ * the input was injected and the time the report was written, giving the
+ * latency through the firmware code and through the kernel input stack.
+ *
+ * The firmware has no HID power-device report yet (battery status goes out
+ * as Serial JSON); a descriptor appended for one is registered the same way.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++11 -O2 -I tools/host -I . -o uhid_bridge \
+ *       tools/uhid_bridge.cpp tools/host/host_arduino.cpp gamepad_utils.cpp macros.cpp \
+ *       input_map.cpp key_pulse.cpp tunables.cpp hires_mouse.cpp nkro_keyboard.cpp turbo.cpp
+ *
+ * Usage:
+ *   uhid_bridge [-n probes] [-i ms] [-g] [-d] [-q]
+ *     -n probes    Number of probes (default: 300)
+ *     -i ms        Time between probes (default: 20)
+ *     -g           Grab the event devices, so probes do not reach the desktop
+ *     -d           Print the report descriptor in hex and exit (no /dev/uhid needed)
+ *     -q           Print only the summary, not one line per probe
+ *
+ * Needs write access to /dev/uhid and read access to /dev/input/event* (root
+ * or a udev rule). Output, one line per probe:
+ *   <probe> <input> <report ids> <input_to_event_us> <write_to_event_us>
+ * followed by a {"uhid_bridge":{...}} summary line.
+ */
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "host_arduino.h"
+#include "gamepad_utils.h"
+#include "input_events.h"
+#include "macros.h"
+#include "input_map.h"
+#include "tunables.h"
+#include "nkro_keyboard.h"
+#include "turbo.h"
+#include "usb_config.h"
+
+// After the firmware headers: linux/input.h defines KEY_* macros that would
+// replace the HID keycode enumerators
+#include <linux/input.h>
+#include <linux/uhid.h>
+
+#define DEVICE_NAME             "LatteDeck Simulation"
+#define DESCRIPTOR_MAX          HID_MAX_DESCRIPTOR_SIZE
+#define JOYSTICK_CENTER         512     // Simulated ADC zero
+#define PROBE_DEFLECTION        300     // Right-stick probe, ADC counts from center
+#define PROBE_INPUT_SOURCE      INPUT_SRC_JOYSTICK_L_SEL    // Space by default
+#define EVENT_TIMEOUT_MS        100     // A probe without an evdev event by then is missed
+#define DEVICE_WAIT_MS          2000    // Time for the kernel to create the event devices
+#define MAX_EVENT_DEVICES       8
+#define MAX_FRAME_REPORTS       8
+
+// ============================================================================
+// Bridge State
+// ============================================================================
+
+enum ProbeInput : uint8_t {
+    PROBE_PRESS = 0,
+    PROBE_RELEASE,
+    PROBE_MOVE,
+    PROBE_INPUT_COUNT
+};
+
+static const char* const probeInputNames[PROBE_INPUT_COUNT] = { "press", "release", "move" };
+
+struct BridgeState {
+    int uhid;
+    int events[MAX_EVENT_DEVICES];
+    int eventCount;
+
+    JoystickData left;
+    JoystickData right;
+    GamepadFrameBuffer gamepad;
+    uint64_t nextTickUs;
+
+    // Reports of the current frame, forwarded after the frame
+    HostHidReport reports[MAX_FRAME_REPORTS];
+    int reportCount;
+
+    uint64_t reportsSent;
+    uint64_t eventsSeen;
+    uint32_t missed;
+    std::vector<uint32_t> inputToEventUs;
+    std::vector<uint32_t> writeToEventUs;
+};
+
+static uint64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void collectReport(const HostHidReport& report, void* context) {
+    BridgeState* state = static_cast<BridgeState*>(context);
+    if (state->reportCount < MAX_FRAME_REPORTS) {
+        state->reports[state->reportCount++] = report;
+    }
+}
+
+// ============================================================================
+// Virtual Device (/dev/uhid)
+// ============================================================================
+
+static bool writeUhid(int fd, const struct uhid_event& ev) {
+    return write(fd, &ev, sizeof(ev)) == (ssize_t)sizeof(ev);
+}
+
+static bool createDevice(BridgeState& state, const uint8_t* descriptor, size_t length) {
+    state.uhid = open("/dev/uhid", O_RDWR | O_CLOEXEC);
+    if (state.uhid < 0) {
+        fprintf(stderr, "uhid_bridge: cannot open /dev/uhid: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct uhid_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = UHID_CREATE2;
+    strncpy((char*)ev.u.create2.name, DEVICE_NAME, sizeof(ev.u.create2.name) - 1);
+    strncpy((char*)ev.u.create2.uniq, LATTE_USB_SERIAL, sizeof(ev.u.create2.uniq) - 1);
+    ev.u.create2.rd_size = length;
+    ev.u.create2.bus = BUS_USB;
+    ev.u.create2.vendor = USB_VID;
+    ev.u.create2.product = USB_PID;
+    memcpy(ev.u.create2.rd_data, descriptor, length);
+    if (!writeUhid(state.uhid, ev)) {
+        fprintf(stderr, "uhid_bridge: UHID_CREATE2 failed: %s\n", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// Answer kernel requests. The firmware keeps no feature state: a SET_REPORT
+// (the wheel resolution multiplier) is acknowledged and dropped, a GET_REPORT
+// fails
+static void serviceUhid(BridgeState& state) {
+    struct uhid_event ev;
+    while (read(state.uhid, &ev, sizeof(ev)) > 0) {
+        if (ev.type == UHID_GET_REPORT || ev.type == UHID_SET_REPORT) {
+            struct uhid_event reply;
+            memset(&reply, 0, sizeof(reply));
+            if (ev.type == UHID_GET_REPORT) {
+                reply.type = UHID_GET_REPORT_REPLY;
+                reply.u.get_report_reply.id = ev.u.get_report.id;
+                reply.u.get_report_reply.err = EIO;
+            } else {
+                reply.type = UHID_SET_REPORT_REPLY;
+                reply.u.set_report_reply.id = ev.u.set_report.id;
+                reply.u.set_report_reply.err = 0;
+            }
+            writeUhid(state.uhid, reply);
+        }
+    }
+}
+
+static bool sendReport(BridgeState& state, const HostHidReport& report) {
+    struct uhid_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = UHID_INPUT2;
+    ev.u.input2.data[0] = report.reportId;
+    memcpy(&ev.u.input2.data[1], report.data, report.length);
+    ev.u.input2.size = report.length + 1;
+    return writeUhid(state.uhid, ev);
+}
+
+// ============================================================================
+// Event Devices
+// ============================================================================
+
+static std::string readSysfsLine(const std::string& path) {
+    char buf[256] = "";
+    FILE* f = fopen(path.c_str(), "r");
+    if (f) {
+        if (!fgets(buf, sizeof(buf), f)) {
+            buf[0] = '\0';
+        }
+        fclose(f);
+    }
+    buf[strcspn(buf, "\n")] = '\0';
+    return buf;
+}
+
+// hid-input names each input device after the HID device, with a suffix per collection
+static int openEventDevices(BridgeState& state, bool grab) {
+    DIR* dir = opendir("/sys/class/input");
+    if (!dir) {
+        return 0;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr && state.eventCount < MAX_EVENT_DEVICES) {
+        if (strncmp(entry->d_name, "event", 5) != 0) {
+            continue;
+        }
+        std::string sys = std::string("/sys/class/input/") + entry->d_name + "/device/";
+        if (readSysfsLine(sys + "name").compare(0, strlen(DEVICE_NAME), DEVICE_NAME) != 0) {
+            continue;
+        }
+
+        std::string dev = std::string("/dev/input/") + entry->d_name;
+        int fd = open(dev.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            fprintf(stderr, "uhid_bridge: cannot open %s: %s\n", dev.c_str(), strerror(errno));
+            continue;
+        }
+        int clock = CLOCK_MONOTONIC;
+        ioctl(fd, EVIOCSCLOCKID, &clock);
+        if (grab) {
+            ioctl(fd, EVIOCGRAB, 1);
+        }
+        state.events[state.eventCount++] = fd;
+        fprintf(stderr, "uhid_bridge: %s (%s)\n", dev.c_str(), readSysfsLine(sys + "name").c_str());
+    }
+    closedir(dir);
+    return state.eventCount;
+}
+
+static void drainEvents(BridgeState& state) {
+    struct input_event ev;
+    for (int i = 0; i < state.eventCount; i++) {
+        while (read(state.events[i], &ev, sizeof(ev)) == (ssize_t)sizeof(ev)) {
+        }
+    }
+}
+
+// Timestamp of the first non-sync evdev event, or 0 on timeout
+static uint64_t waitForEvent(BridgeState& state, uint64_t deadlineUs) {
+    struct pollfd fds[MAX_EVENT_DEVICES + 1];
+    for (int i = 0; i < state.eventCount; i++) {
+        fds[i].fd = state.events[i];
+        fds[i].events = POLLIN;
+    }
+    fds[state.eventCount].fd = state.uhid;
+    fds[state.eventCount].events = POLLIN;
+
+    uint64_t now;
+    while ((now = monotonicUs()) < deadlineUs) {
+        int timeoutMs = (int)((deadlineUs - now + 999) / 1000);
+        if (poll(fds, state.eventCount + 1, timeoutMs) <= 0) {
+            continue;
+        }
+        if (fds[state.eventCount].revents & POLLIN) {
+            serviceUhid(state);
+        }
+        for (int i = 0; i < state.eventCount; i++) {
+            struct input_event ev;
+            while (read(state.events[i], &ev, sizeof(ev)) == (ssize_t)sizeof(ev)) {
+                if (ev.type != EV_SYN && ev.type != EV_MSC) {
+                    state.eventsSeen++;
+                    return (uint64_t)ev.input_event_sec * 1000000 + ev.input_event_usec;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// ============================================================================
+// Firmware Frame
+// ============================================================================
+
+// Same order as loopGamepad(): sample, button edges, input ticks, report frame
+static void runFrame(BridgeState& state) {
+    uint64_t now = monotonicUs();
+    hostSetMicros(now);
+
+    sampleJoysticks(state.left, state.right, state.gamepad.next());
+    loopInputMap((uint32_t)now);
+    loopMacros(millis());
+
+    while (state.nextTickUs <= now) {
+        turboTick();
+        state.nextTickUs += TURBO_TICK_US;
+    }
+
+    GamepadFrame& frame = state.gamepad.next();
+    frame.timestampUs = (uint32_t)now;
+    processJoystickFrame(state.gamepad.previous(), frame, state.left, state.right, tunables.mouseSensitivity);
+    applyTurbo();
+    flushGamepadKeyboard();
+    state.gamepad.commit();
+}
+
+static void injectInput(uint8_t input) {
+    switch (input) {
+        case PROBE_PRESS:
+        case PROBE_RELEASE: {
+            InputEvent event;
+            event.timestampUs = (uint32_t)monotonicUs();
+            event.source = PROBE_INPUT_SOURCE;
+            event.pressed = input == PROBE_PRESS;
+            mapInputEvent(event);
+            break;
+        }
+        case PROBE_MOVE:
+            hostSetAnalog(PIN_JOYSTICK_R_X, JOYSTICK_CENTER + PROBE_DEFLECTION);
+            break;
+    }
+}
+
+// One probe: inject, run the frame, forward its reports and time the evdev event
+static void runProbe(BridgeState& state, uint32_t probe, bool quiet) {
+    uint8_t input = probe % PROBE_INPUT_COUNT;
+    drainEvents(state);
+
+    state.reportCount = 0;
+    uint64_t inputUs = monotonicUs();
+    injectInput(input);
+    runFrame(state);
+
+    uint64_t writeUs = monotonicUs();
+    for (int i = 0; i < state.reportCount; i++) {
+        if (sendReport(state, state.reports[i])) {
+            state.reportsSent++;
+        }
+    }
+    int reportCount = state.reportCount;
+    HostHidReport first = state.reports[0];
+
+    uint64_t eventUs = reportCount ? waitForEvent(state, writeUs + EVENT_TIMEOUT_MS * 1000) : 0;
+
+    // Center the stick again, outside the measurement
+    if (input == PROBE_MOVE) {
+        hostSetAnalog(PIN_JOYSTICK_R_X, JOYSTICK_CENTER);
+        state.reportCount = 0;
+        runFrame(state);
+        for (int i = 0; i < state.reportCount; i++) {
+            sendReport(state, state.reports[i]);
+        }
+    }
+
+    if (!reportCount) {
+        return;
+    }
+    if (!eventUs) {
+        state.missed++;
+        if (!quiet) {
+            printf("%u %s %u missed\n", probe, probeInputNames[input], first.reportId);
+        }
+        return;
+    }
+
+    uint32_t inputToEvent = (uint32_t)(eventUs - inputUs);
+    uint32_t writeToEvent = eventUs > writeUs ? (uint32_t)(eventUs - writeUs) : 0;
+    state.inputToEventUs.push_back(inputToEvent);
+    state.writeToEventUs.push_back(writeToEvent);
+    if (!quiet) {
+        printf("%u %s %u %u %u\n", probe, probeInputNames[input], first.reportId, inputToEvent, writeToEvent);
+    }
+}
+
+// ============================================================================
+// Summary
+// ============================================================================
+
+static void printPercentiles(const char* name, std::vector<uint32_t>& samples) {
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    printf(",\"%s\":{", name);
+    if (n) {
+        printf("\"min\":%u,\"p50\":%u,\"p99\":%u,\"max\":%u",
+               samples[0], samples[n / 2], samples[(n * 99) / 100], samples[n - 1]);
+    }
+    putchar('}');
+}
+
+static void printDescriptor(const uint8_t* descriptor, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        printf("%02x%c", descriptor[i], (i % 16 == 15 || i + 1 == length) ? '\n' : ' ');
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    uint32_t probes = 300;
+    uint32_t intervalMs = 20;
+    bool grab = false;
+    bool dump = false;
+    bool quiet = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:i:gdq")) != -1) {
+        switch (opt) {
+            case 'n': probes = atoi(optarg); break;
+            case 'i': intervalMs = atoi(optarg); break;
+            case 'g': grab = true; break;
+            case 'd': dump = true; break;
+            case 'q': quiet = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n probes] [-i ms] [-g] [-d] [-q]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    uint8_t descriptor[DESCRIPTOR_MAX];
+    size_t length = hostGetHidDescriptor(descriptor, sizeof(descriptor));
+    if (length == 0 || length > sizeof(descriptor)) {
+        fprintf(stderr, "uhid_bridge: report descriptor is %zu bytes\n", length);
+        return 1;
+    }
+    if (dump) {
+        printDescriptor(descriptor, length);
+        return 0;
+    }
+
+    BridgeState state;
+    state.eventCount = 0;
+    state.gamepad.reset();
+    state.reportsSent = 0;
+    state.eventsSeen = 0;
+    state.missed = 0;
+
+    if (!createDevice(state, descriptor, length)) {
+        return 1;
+    }
+    fcntl(state.uhid, F_SETFL, O_NONBLOCK);
+
+    // The kernel creates the input devices after UHID_START
+    uint64_t deadline = monotonicUs() + DEVICE_WAIT_MS * 1000;
+    while (monotonicUs() < deadline && openEventDevices(state, grab) == 0) {
+        serviceUhid(state);
+        usleep(20000);
+    }
+    if (state.eventCount == 0) {
+        fprintf(stderr, "uhid_bridge: no event device for \"%s\" (descriptor rejected?)\n", DEVICE_NAME);
+        return 1;
+    }
+
+    // Firmware side: centered sticks, calibrated like setupGamepad()
+    initializeJoystick(state.left, PIN_JOYSTICK_L_X, PIN_JOYSTICK_L_Y, PIN_JOYSTICK_L_SEL);
+    initializeJoystick(state.right, PIN_JOYSTICK_R_X, PIN_JOYSTICK_R_Y, PIN_JOYSTICK_R_SEL);
+    hostSetAnalog(PIN_JOYSTICK_L_X, JOYSTICK_CENTER);
+    hostSetAnalog(PIN_JOYSTICK_L_Y, JOYSTICK_CENTER);
+    hostSetAnalog(PIN_JOYSTICK_R_X, JOYSTICK_CENTER);
+    hostSetAnalog(PIN_JOYSTICK_R_Y, JOYSTICK_CENTER);
+    calibrateJoystick(state.left);
+    calibrateJoystick(state.right);
+    setupInputMap();
+    hostSetHidSink(collectReport, &state);
+    state.nextTickUs = monotonicUs();
+
+    for (uint32_t probe = 0; probe < probes; probe++) {
+        runProbe(state, probe, quiet);
+        usleep(intervalMs * 1000);
+        serviceUhid(state);
+    }
+
+    printf("{\"uhid_bridge\":{\"descriptor_bytes\":%zu,\"event_devices\":%d,\"probes\":%u,"
+           "\"reports\":%llu,\"events\":%llu,\"missed\":%u",
+           length, state.eventCount, probes, (unsigned long long)state.reportsSent,
+           (unsigned long long)state.eventsSeen, state.missed);
+    printPercentiles("input_to_event_us", state.inputToEventUs);
+    printPercentiles("write_to_event_us", state.writeToEventUs);
+    printf("}}\n");
+
+    struct uhid_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = UHID_DESTROY;
+    writeUhid(state.uhid, ev);
+    close(state.uhid);
+    return state.missed == 0 ? 0 : 1;
+}
@@ -0,0 +1,200 @@
+/*
+ * ups_fuzz.cpp
+ *
+ * Property checks and fuzz target for the UPS battery conversion
+ * (parseBatteryRegisters(), calculateSoC()). The register block comes straight
+ * from I2C, so every byte pattern must give a sane status:
+ *   - SoC stays within 0-100 %
+ *   - SoC is monotonic in VBAT at a fixed discharge current
+ *   - the 32-bit sag product (current * R_INTERNAL_mOHM) cannot wrap
+ *   - VBAT raw 0 reports no battery
+ *
+ * Build the sweep (from the repository root):
+ *   g++ -std=c++11 -O2 -I tools/host -I . -o ups_fuzz \
+ *       tools/ups_fuzz.cpp tools/host/host_arduino.cpp ups_battery.cpp
+ *
+ * Build as a libFuzzer target (clang):
+ *   clang++ -std=c++11 -O1 -g -fsanitize=fuzzer,address,undefined -DUPS_FUZZ_LIBFUZZER \
+ *       -I tools/host -I . -o ups_fuzz tools/ups_fuzz.cpp tools/host/host_arduino.cpp ups_battery.cpp
+ *
+ * Usage:
+ *   ups_fuzz [-n rounds]
+ *     Exhaustive sweep of the ADC bytes and the SoC inputs, then a throughput
+ *     run of parseBatteryRegisters() over the VBAT/ICHG/IDCHG codes
+ *     (default 100 rounds). Prints "parses/s" to stderr; exits 1 on the first
+ *     violated property.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "ups_battery.h"
+
+#define UPS_FUZZ_DEFAULT_ROUNDS     100
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "ups_fuzz: " __VA_ARGS__); \
+            fputc('\n', stderr); \
+            abort(); \
+        } \
+    } while (0)
+
+// calculateSoC() takes any uint16_t current, not only the 7-bit IDCHG codes
+static_assert((uint64_t)0xFFFF * R_INTERNAL_mOHM <= 0xFFFFFFFFULL,
+              "Sag product of calculateSoC() must fit 32 bits");
+
+// ============================================================================
+// Properties
+// ============================================================================
+
+static void checkSoCRange(uint16_t v_pack_mV, uint16_t current_mA) {
+    uint16_t soc = calculateSoC(v_pack_mV, current_mA);
+    CHECK(soc <= 100, "SoC %u %% at %u mV, %u mA", soc, v_pack_mV, current_mA);
+}
+
+static void checkRegisters(const CS32RegisterMap& regs) {
+    SimpleUPSStatus status;
+    memset(&status, 0xA5, sizeof(status));
+    bool ok = parseBatteryRegisters(regs, status);
+
+    if (!regs.hasBattery()) {
+        CHECK(!ok && status.voltage_mV == 0, "VBAT raw 0 must report no battery");
+        return;
+    }
+    CHECK(ok, "VBAT raw %u rejected", regs.adcVbat);
+    CHECK(status.voltage_mV == regs.vbat_mV(), "voltage %u mV for VBAT raw %u",
+          status.voltage_mV, regs.adcVbat);
+    CHECK(status.voltage_mV >= CS32_VBAT_OFFSET_mV, "voltage %u mV below the ADC floor",
+          status.voltage_mV);
+    CHECK(status.capacity_percent <= 100, "SoC %u %% for VBAT raw %u, IDCHG raw %u",
+          status.capacity_percent, regs.adcVbat, regs.adcIdchg);
+    CHECK(status.is_charging == (regs.ichg_mA() > 0), "charge flag for ICHG raw %u", regs.adcIchg);
+}
+
+static bool nearThreshold(uint32_t current, uint32_t threshold) {
+    return current + 2 >= threshold && current <= threshold + 2;
+}
+
+// Whole input space of calculateSoC() for the range; every voltage at every 64th
+// current and around the compensation and table thresholds for monotonicity
+static void sweepSoC() {
+    for (uint32_t current = 0; current <= 0xFFFF; current++) {
+        uint16_t previous = 0;
+        bool monotonic = (current & 0x3F) == 0
+            || nearThreshold(current, SOC_DISCHARGE_COMP_MIN_mA)
+            || nearThreshold(current, SOC_HIGH_CURRENT_mA);
+        for (uint32_t v = 0; v <= 0xFFFF; v += monotonic ? 1 : 97) {
+            uint16_t soc = calculateSoC((uint16_t)v, (uint16_t)current);
+            CHECK(soc <= 100, "SoC %u %% at %u mV, %u mA", soc, (unsigned)v, (unsigned)current);
+            if (monotonic) {
+                CHECK(soc >= previous, "SoC falls from %u to %u %% at %u mV, %u mA",
+                      previous, soc, (unsigned)v, (unsigned)current);
+                previous = soc;
+            }
+        }
+    }
+    checkSoCRange(0xFFFF, 0xFFFF);
+}
+
+// Every ADC byte the parser reads, including the bits above the 7-bit current mask
+static void sweepRegisters() {
+    CS32RegisterMap regs;
+    memset(&regs, 0, sizeof(regs));
+    for (int idchg = 0; idchg < 256; idchg++) {
+        regs.adcIdchg = idchg;
+        for (int ichg = 0; ichg < 256; ichg++) {
+            regs.adcIchg = ichg;
+            uint16_t previous = 0;
+            for (int vbat = 0; vbat < 256; vbat++) {
+                regs.adcVbat = vbat;
+                checkRegisters(regs);
+
+                SimpleUPSStatus status;
+                if (parseBatteryRegisters(regs, status)) {
+                    CHECK(status.capacity_percent >= previous,
+                          "SoC falls from %u to %u %% at VBAT raw %d, IDCHG raw %d, ICHG raw %d",
+                          previous, status.capacity_percent, vbat, idchg, ichg);
+                    previous = status.capacity_percent;
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// libFuzzer Entry
+// ============================================================================
+
+// Input: the register block as read over I2C, optionally followed by a raw
+// calculateSoC() voltage and current (little endian)
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    CS32RegisterMap regs;
+    memset(&regs, 0, sizeof(regs));
+    memcpy(&regs, data, size < sizeof(regs) ? size : sizeof(regs));
+    checkRegisters(regs);
+
+    if (size >= sizeof(regs) + 4) {
+        const uint8_t* extra = data + sizeof(regs);
+        checkSoCRange(extra[0] | (extra[1] << 8), extra[2] | (extra[3] << 8));
+    }
+    return 0;
+}
+
+// ============================================================================
+// Sweep and Throughput
+// ============================================================================
+
+#ifndef UPS_FUZZ_LIBFUZZER
+int main(int argc, char** argv) {
+    long rounds = UPS_FUZZ_DEFAULT_ROUNDS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            rounds = strtol(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: ups_fuzz [-n rounds]\n");
+            return 1;
+        }
+    }
+    if (rounds < 1) {
+        rounds = 1;
+    }
+
+    sweepSoC();
+    sweepRegisters();
+    fprintf(stderr, "properties: ok (SoC range and voltage monotonicity, sag product, VBAT raw 0)\n");
+
+    // Valid current codes (ICHG every 7th) at every VBAT, without the checks: the cost of the parse itself
+    CS32RegisterMap regs;
+    memset(&regs, 0, sizeof(regs));
+    SimpleUPSStatus status;
+    uint32_t sink = 0;
+    uint64_t parses = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long round = 0; round < rounds; round++) {
+        for (int idchg = 0; idchg < 128; idchg++) {
+            regs.adcIdchg = idchg;
+            for (int ichg = 0; ichg < 128; ichg += 7) {
+                regs.adcIchg = ichg;
+                for (int vbat = 0; vbat < 256; vbat++) {
+                    regs.adcVbat = vbat;
+                    if (parseBatteryRegisters(regs, status)) {
+                        sink += status.capacity_percent;
+                    }
+                    parses++;
+                }
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    fprintf(stderr, "parses: %llu, time: %.6f s", (unsigned long long)parses, elapsed);
+    if (elapsed > 0) {
+        fprintf(stderr, " (%.0f parses/s)", parses / elapsed);
+    }
+    fprintf(stderr, ", checksum %u\n", (unsigned)sink);
+    return 0;
+}
+#endif
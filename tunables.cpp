@@ -0,0 +1,12 @@
+#include "tunables.h"
+
+Tunables tunables = {
+    JOYSTICK_MOUSE_SENSITIVITY,
+    JOYSTICK_SIDE_MAX,
+    JOYSTICK_BINARY_THRESHOLD,
+    SPRINT_THRESHOLD,
+    0,
+    1,
+    1,
+    TURBO_RATE_HZ,
+};
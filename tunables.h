@@ -0,0 +1,26 @@
+#ifndef TUNABLES_H
+#define TUNABLES_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ============================================================================
+// Runtime Tunables
+// ============================================================================
+// Values that can be changed over the serial console without reflashing. The
+// defaults are the compile-time settings from config.h / gamepad_assignment.h.
+
+struct Tunables {
+    uint16_t mouseSensitivity;      // JOYSTICK_MOUSE_SENSITIVITY (higher = slower)
+    uint16_t sideMax;               // JOYSTICK_SIDE_MAX
+    uint16_t binaryThreshold;       // JOYSTICK_BINARY_THRESHOLD
+    uint16_t sprintThreshold;       // SPRINT_THRESHOLD
+    uint16_t upsPollMs;             // UPS poll interval override, 0 = adaptive (governor ceiling)
+    uint16_t debugGamepad;          // Mute/unmute DEBUG_PRINT_GAMEPAD output
+    uint16_t debugUps;              // Mute/unmute DEBUG_PRINT_UPS output
+    uint16_t turboRateHz;           // TURBO_RATE_HZ
+};
+
+extern Tunables tunables;
+
+#endif // TUNABLES_H
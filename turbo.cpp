@@ -0,0 +1,57 @@
+#include "turbo.h"
+#include <util/atomic.h>
+
+// ============================================================================
+// Generator State
+// ============================================================================
+
+static volatile bool turboRunning = false;
+static volatile bool turboPressPhase = false;       // Written by the ISR
+static volatile uint32_t turboToggles = 0;
+static uint32_t halfPeriodUs = 0;                   // Set before turboRunning
+static uint32_t phaseUs = 0;                        // Time into the current half (ISR only)
+
+// ============================================================================
+// Public Functions
+// ============================================================================
+
+void startTurbo(uint16_t rateHz) {
+    if (rateHz == 0) {
+        rateHz = 1;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        halfPeriodUs = 500000UL / rateHz;
+        phaseUs = 0;
+        turboPressPhase = true;
+        turboRunning = true;
+    }
+}
+
+void stopTurbo() {
+    turboRunning = false;
+}
+
+void turboTick() {
+    if (!turboRunning) {
+        return;
+    }
+    // The remainder carries over, so the rate has no rounding drift
+    phaseUs += TURBO_TICK_US;
+    if (phaseUs >= halfPeriodUs) {
+        phaseUs -= halfPeriodUs;
+        turboPressPhase = !turboPressPhase;
+        turboToggles++;
+    }
+}
+
+bool getTurboPhase() {
+    return turboPressPhase;
+}
+
+uint32_t getTurboToggles() {
+    uint32_t toggles;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        toggles = turboToggles;
+    }
+    return toggles;
+}
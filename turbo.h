@@ -0,0 +1,38 @@
+#ifndef TURBO_H
+#define TURBO_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ============================================================================
+// Turbo Generator
+// ============================================================================
+// Actions bound with ACTION_TURBO() auto-fire while their button is held. The
+// on/off phase is generated in the 1 kHz input tick (Timer0 compare A) from a
+// microsecond accumulator, so the average rate is exact regardless of loop
+// timing. The input map applies phase changes at HID report frames only, so
+// every press and release lands on the report schedule; the main loop reads
+// one byte per frame and does nothing else while no turbo button is held.
+
+#define TURBO_TICK_US               1024    // Timer0 compare A period (64 x 256 / 16 MHz)
+
+static_assert(TURBO_RATE_MAX_HZ <= 500000UL / 8000, "Half period must cover the slowest report interval (8 ms)");
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Start with the press phase / stop the generator (main loop)
+void startTurbo(uint16_t rateHz);
+void stopTurbo();
+
+// Advance the phase by one tick (interrupt context)
+void turboTick();
+
+// true = press phase
+bool getTurboPhase();
+
+// Phase changes generated since boot
+uint32_t getTurboToggles();
+
+#endif // TURBO_H
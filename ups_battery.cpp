@@ -0,0 +1,179 @@
+#include "ups_battery.h"
+
+// Battery SoC calculation tables
+static const int N = 11;
+static const uint16_t SOC_PCT[N] PROGMEM = {  0,   10,  20,  30,  40,  50,  60,  70,  80,  90, 100};
+static const uint16_t OCV_mV_A8[N] PROGMEM = {2600,3000,3150,3300,3450,3600,3750,3850,3940,4040,4150};
+static const uint16_t OCV_mV_2A[N] PROGMEM = {2600,2900,3070,3220,3370,3520,3670,3780,3900,3980,4100};
+
+// ============================================================================
+// Register Parsing
+// ============================================================================
+
+bool parseBatteryRegisters(const CS32RegisterMap& regs, SimpleUPSStatus& status) {
+    if (!regs.hasBattery()) {
+        status.voltage_mV = 0; // No battery connected
+        return false;
+    }
+    status.voltage_mV = regs.vbat_mV();
+    
+    // Charge and discharge current (computed unsigned: 127 * 256 does not fit a 16-bit int)
+    uint16_t chargeCurrent = regs.ichg_mA();
+    uint16_t dischargeCurrent = regs.idchg_mA();
+    
+    // Determine if charging or discharging
+    if (chargeCurrent > 0) {
+        status.current_mA = chargeCurrent;
+        status.is_charging = true;
+    } else {
+        status.current_mA = dischargeCurrent;
+        status.is_charging = false;
+    }
+    
+    // Calculate capacity percentage
+    status.capacity_percent = calculateSoC(status.voltage_mV, status.is_charging ? 0 : dischargeCurrent);
+    
+    return true;
+}
+
+// ============================================================================
+// State of Charge
+// ============================================================================
+
+uint16_t calculateSoC(uint16_t v_pack_mV, uint16_t dischargeCurrent_mA) {
+    // Compensate for internal resistance sag (32-bit: 32.5 A * 300 mOhm overflows 16 bits)
+    uint32_t v_rest_mV = v_pack_mV / N_CELLS_PACK;
+    if (dischargeCurrent_mA > SOC_DISCHARGE_COMP_MIN_mA) {
+        v_rest_mV += (uint32_t)dischargeCurrent_mA * R_INTERNAL_mOHM / 1000;
+    }
+
+    // Select proper OCV table
+    const uint16_t *OCV_V = OCV_mV_A8;
+    if (dischargeCurrent_mA > SOC_HIGH_CURRENT_mA) {
+        OCV_V = OCV_mV_2A;
+    }
+
+    uint16_t v0 = pgm_read_word(&OCV_V[0]);
+    if (v_rest_mV <= v0) return pgm_read_word(&SOC_PCT[0]);
+    if (v_rest_mV >= pgm_read_word(&OCV_V[N - 1])) return pgm_read_word(&SOC_PCT[N - 1]);
+
+    // Integer interpolation; exact at the table points, so the result is monotonic in voltage
+    for (int i = 0; i < N - 1; ++i) {
+        uint16_t v1 = pgm_read_word(&OCV_V[i + 1]);
+        if (v_rest_mV <= v1) {
+            uint16_t soc0 = pgm_read_word(&SOC_PCT[i]);
+            uint16_t soc1 = pgm_read_word(&SOC_PCT[i + 1]);
+            return soc0 + (uint16_t)((v_rest_mV - v0) * (soc1 - soc0) / (v1 - v0));
+        }
+        v0 = v1;
+    }
+
+    return pgm_read_word(&SOC_PCT[N - 1]);
+}
+
+// ============================================================================
+// Adaptive Polling
+// ============================================================================
+
+// Battery current with sign: positive while charging
+static int32_t signedCurrent(const SimpleUPSStatus& status) {
+    return status.is_charging ? (int32_t)status.current_mA : -(int32_t)status.current_mA;
+}
+
+// Change per second beyond the noise band
+static uint32_t slewPerSecond(int32_t delta, uint16_t noise, uint32_t elapsed_ms) {
+    uint32_t magnitude = delta < 0 ? -delta : delta;
+    if (magnitude <= noise) {
+        return 0;
+    }
+    return (magnitude - noise) * 1000UL / elapsed_ms;
+}
+
+uint32_t adaptPollInterval(const SimpleUPSStatus& previous, const SimpleUPSStatus& current,
+                           uint32_t elapsed_ms, uint32_t interval_ms, uint32_t ceiling_ms) {
+    if (elapsed_ms == 0) {
+        elapsed_ms = 1;
+    }
+
+    int32_t dV = (int32_t)current.voltage_mV - (int32_t)previous.voltage_mV;
+    int32_t dI = signedCurrent(current) - signedCurrent(previous);
+    if (current.is_charging != previous.is_charging
+        || slewPerSecond(dV, UPS_ADAPT_VOLTAGE_NOISE_mV, elapsed_ms) >= UPS_ADAPT_FAST_mV_PER_S
+        || slewPerSecond(dI, UPS_ADAPT_CURRENT_NOISE_mA, elapsed_ms) >= UPS_ADAPT_FAST_mA_PER_S) {
+        return UPS_POLL_MIN_MS;
+    }
+
+    uint32_t next = interval_ms + interval_ms / 2;
+    if (next < UPS_POLL_MIN_MS) {
+        next = UPS_POLL_MIN_MS;
+    }
+    return next < ceiling_ms ? next : ceiling_ms;
+}
+
+// ============================================================================
+// Power Model
+// ============================================================================
+
+void parsePowerRegisters(const CS32RegisterMap& regs, UpsPowerSample& sample) {
+    // 32-bit products: 19.5 V * 12.75 A does not fit 16 bits in either unit
+    uint16_t vbus = regs.vbus_mV();
+    sample.input_mW = vbus >= UPS_VBUS_PRESENT_mV ? (uint32_t)vbus * regs.iin_mA() / 1000 : 0;
+
+    if (regs.hasBattery()) {
+        uint16_t charge = regs.ichg_mA();
+        uint32_t current = charge > 0 ? charge : regs.idchg_mA();
+        int32_t power = (int32_t)((uint32_t)regs.vbat_mV() * current / 1000);
+        sample.battery_mW = charge > 0 ? power : -power;
+    } else {
+        sample.battery_mW = 0;
+    }
+
+    sample.vsys_mV = regs.vsys_mV();
+    sample.psys_mV = regs.psys_mV();
+
+    #if UPS_PSYS_mV_PER_W
+    sample.system_mW = (uint32_t)sample.psys_mV * 1000 / UPS_PSYS_mV_PER_W;
+    #else
+    // Whatever the adapter delivers and the battery does not take; ADC steps can undershoot 0
+    int32_t system = (int32_t)sample.input_mW - sample.battery_mW;
+    sample.system_mW = system > 0 ? system : 0;
+    #endif
+}
+
+// Move an average towards a value by elapsed / (elapsed + tau)
+static int32_t runningAverage(int32_t average, int32_t value, uint32_t elapsed_ms) {
+    if (elapsed_ms > 8 * UPS_POWER_AVG_TAU_MS) {
+        return value;
+    }
+    int32_t weight = (int32_t)(elapsed_ms * 1024 / (elapsed_ms + UPS_POWER_AVG_TAU_MS));
+    return average + (value - average) * weight / 1024;
+}
+
+void updatePowerModel(UpsPowerModel& model, const UpsPowerSample& sample, uint32_t elapsed_ms) {
+    if (!model.valid) {
+        model.avgInput_mW = sample.input_mW;
+        model.avgSystem_mW = sample.system_mW;
+        model.avgBattery_mW = sample.battery_mW;
+        resetPowerPeaks(model);
+        model.valid = true;
+    } else {
+        model.avgInput_mW = runningAverage(model.avgInput_mW, sample.input_mW, elapsed_ms);
+        model.avgSystem_mW = runningAverage(model.avgSystem_mW, sample.system_mW, elapsed_ms);
+        model.avgBattery_mW = runningAverage(model.avgBattery_mW, sample.battery_mW, elapsed_ms);
+    }
+
+    uint32_t discharge = sample.battery_mW < 0 ? -sample.battery_mW : 0;
+    if (sample.input_mW > model.peakInput_mW) model.peakInput_mW = sample.input_mW;
+    if (sample.system_mW > model.peakSystem_mW) model.peakSystem_mW = sample.system_mW;
+    if (discharge > model.peakDischarge_mW) model.peakDischarge_mW = discharge;
+    if (model.samples < 0xFFFF) model.samples++;
+
+    model.last = sample;
+}
+
+void resetPowerPeaks(UpsPowerModel& model) {
+    model.peakInput_mW = 0;
+    model.peakSystem_mW = 0;
+    model.peakDischarge_mW = 0;
+    model.samples = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef UPS_BATTERY_H
+#define UPS_BATTERY_H
+
+#include <Arduino.h>
+#include "ups_simple.h"
+#include "cs32_registers.h"
+
+// ============================================================================
+// Battery Data Conversion
+// ============================================================================
+// Pure conversion of raw UPS ADC registers into battery status. No I2C, timing
+// or global state, so the functions can also be built and exercised on a host.
+
+#define SOC_DISCHARGE_COMP_MIN_mA   100     // Below this no sag compensation is applied
+#define SOC_HIGH_CURRENT_mA         1200    // Use the 2 A OCV curve above this discharge current
+
+// Adaptive polling: changes up to the noise band are ADC jitter, not battery dynamics
+#define UPS_ADAPT_VOLTAGE_NOISE_mV  (2 * CS32_VBAT_LSB_mV)
+#define UPS_ADAPT_CURRENT_NOISE_mA  (2 * CS32_IDCHG_LSB_mA)
+#define UPS_ADAPT_FAST_mV_PER_S     30      // Voltage slew that drops to the minimum poll interval
+#define UPS_ADAPT_FAST_mA_PER_S     100     // Current slew that drops to the minimum poll interval
+
+// System power model
+#define UPS_POWER_AVG_TAU_MS        30000   // Time constant of the running averages
+#define UPS_PSYS_mV_PER_W           0       // PSYS pin scale of the board (0 = unknown: system power
+                                            // from the input/battery balance instead)
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// Fill voltage, current, charging flag and capacity from the chip data registers.
+// Returns false when the registers carry no battery voltage (VBAT raw 0).
+bool parseBatteryRegisters(const CS32RegisterMap& regs, SimpleUPSStatus& status);
+
+// State of charge (0-100 %) of the pack from its voltage and discharge current
+uint16_t calculateSoC(uint16_t v_pack_mV, uint16_t dischargeCurrent_mA);
+
+// Next poll interval from two consecutive samples taken elapsed_ms apart.
+// A charge state change or a fast voltage/current slew returns UPS_POLL_MIN_MS;
+// a steady battery grows the interval by half per poll, up to ceiling_ms.
+uint32_t adaptPollInterval(const SimpleUPSStatus& previous, const SimpleUPSStatus& current,
+                           uint32_t elapsed_ms, uint32_t interval_ms, uint32_t ceiling_ms);
+
+// Power model: the adapter delivers VBUS * IIN, the battery takes or gives
+// VBAT * ICHG/IDCHG and the system draws the rest (converter losses included).
+// Averages follow elapsed time, not the number of polls, so the adaptive poll
+// rate does not skew them.
+void parsePowerRegisters(const CS32RegisterMap& regs, UpsPowerSample& sample);
+
+// Add a sample taken elapsed_ms after the previous one; the first sample starts the averages
+void updatePowerModel(UpsPowerModel& model, const UpsPowerSample& sample, uint32_t elapsed_ms);
+
+// Start a new peak window (after the peaks were published)
+void resetPowerPeaks(UpsPowerModel& model);
+
+#endif // UPS_BATTERY_H
@@ -1,31 +1,37 @@
 #include "ups_simple.h"
+#include "ups_battery.h"
 #include "DFRobot_LPUPS.h"
+#include "status_led.h"
+#include "tunables.h"
+#include "console.h"
+#include "watchdog.h"
+#include "persist_store.h"
 #include <Wire.h>
 
-// DFRobot LPUPS Register Definitions
-#define CS32_I2C_ADC_VBAT_REG         0x0CU   // VBAT: Full range: 2.88 V - 19.2 V, LSB 64 mV
-#define CS32_I2C_ADC_ICHG_REG         0x09U   // ICHG: Full range 8.128 A, LSB 64 mA
-#define CS32_I2C_ADC_IDCHG_REG        0x08U   // IDCHG: Full range: 32.512 A, LSB 256 mA
-
-// Battery SoC calculation tables
-static const int N = 11;
-static const uint16_t SOC_PCT[N] PROGMEM = {  0,   10,  20,  30,  40,  50,  60,  70,  80,  90, 100};
-static const uint16_t OCV_mV_A8[N] PROGMEM = {2600,3000,3150,3300,3450,3600,3750,3850,3940,4040,4150};
-static const uint16_t OCV_mV_2A[N] PROGMEM = {2600,2900,3070,3220,3370,3520,3670,3780,3900,3980,4100};
-
 // ============================================================================
 // Global UPS Instance
 // ============================================================================
 
 SimpleUPS simple_ups;
 
+#if ENABLE_PERSIST_STORE
+static_assert(sizeof(SimpleUPSStatus) <= PERSIST_MAX_DATA, "Battery estimate must fit one store record");
+#endif
+
 // ============================================================================
 // SimpleUPS Class Implementation
 // ============================================================================
 
 SimpleUPS::SimpleUPS() : ups_library(nullptr), initialized(false), connected(false), 
-                        last_read_ms(0), last_report_ms(0), last_led_update_ms(0),
-                        consecutive_failures(0), led_cycle_start_ms(0), led_brightness(0), led_state(false) {
+                        last_read_ms(0), last_report_ms(0),
+                        consecutive_failures(0), read_interval_ms(UPS_READ_INTERVAL_MS),
+                        adaptive_interval_ms(UPS_POLL_MIN_MS), last_vbus_ms(0),
+                        vbus_present(false), poll_now(false), poll_count(0), vbus_poll_count(0),
+                        last_poll_us(0), max_poll_us(0),
+                        led_animation(UPS_LED_ANIM_FULL), fault_flags(0), last_power_report_ms(0),
+                        persisted_capacity(0xFFFF), persisted_charging(false) {
+    memset(&registers, 0, sizeof(registers));
+    memset(&power_model, 0, sizeof(power_model));
     current_status.voltage_mV = 0;
     current_status.current_mA = 0;
     current_status.capacity_percent = 0;
@@ -43,7 +49,7 @@ SimpleUPS::~SimpleUPS() {
 
 bool SimpleUPS::begin() {
     #if DEBUG_PRINT_UPS
-    Serial.println("UPS: Initializing...");
+    upsDebug.println("UPS: Initializing...");
     #endif
     
     // Initialize I2C
@@ -54,7 +60,7 @@ bool SimpleUPS::begin() {
     ups_library = new DFRobot_LPUPS_I2C();
     if (!ups_library) {
         #if DEBUG_PRINT_UPS
-        Serial.println("UPS: Library allocation failed");
+        upsDebug.println("UPS: Library allocation failed");
         #endif
         return false;
     }
@@ -62,8 +68,8 @@ bool SimpleUPS::begin() {
     int result = ups_library->begin();
     if (result != 0) {
         #if DEBUG_PRINT_UPS
-        Serial.print("UPS: Library initialization failed: ");
-        Serial.println(result);
+        upsDebug.print("UPS: Library initialization failed: ");
+        upsDebug.println(result);
         #endif
         delete ups_library;
         ups_library = nullptr;
@@ -74,22 +80,43 @@ bool SimpleUPS::begin() {
     ups_library->setMaxChargeVoltage(12600); // 12.6V for 3 cells
     
     // Test communication
-    uint8_t regBuf[32];
-    if (readRawData(regBuf)) {
+    if (readRawData() && registers.hasBattery()) {
         initialized = true;
         connected = true;
+        vbus_present = registers.vbus_mV() >= UPS_VBUS_PRESENT_mV;
+        
+        // Last estimate from before a warm restart (or from EEPROM after a power-off),
+        // until the first poll replaces it
+        bool restored = false;
+        #if ENABLE_WATCHDOG
+        if (isWarmRestart() && (getWarmState().validMask & WARM_VALID_UPS)) {
+            current_status = getWarmState().upsStatus;
+            restored = true;
+        }
+        #endif
+        #if ENABLE_PERSIST_STORE
+        if (!restored && persistRestore(PERSIST_KEY_UPS_STATUS, &current_status, sizeof(current_status))) {
+            current_status.last_update_ms = 0;
+            restored = true;
+        }
+        #endif
+        if (restored) {
+            current_status.is_connected = false;
+            persisted_capacity = current_status.capacity_percent;
+            persisted_charging = current_status.is_charging;
+        }
         
-        // Initialize status LED
-        pinMode(UPS_STATUS_LED, OUTPUT);
-        digitalWrite(UPS_STATUS_LED, LOW);
+        // Start the status LED engine
+        beginStatusLed();
+        updateStatusLED();
         
         #if DEBUG_PRINT_UPS
-        Serial.println("UPS: Initialization successful");
+        upsDebug.println("UPS: Initialization successful");
         #endif
         return true;
     } else {
         #if DEBUG_PRINT_UPS
-        Serial.println("UPS: Communication test failed");
+        upsDebug.println("UPS: Communication test failed");
         #endif
         delete ups_library;
         ups_library = nullptr;
@@ -104,195 +131,282 @@ void SimpleUPS::update() {
     
     uint32_t current_time = millis();
     
-    if (current_time - last_read_ms >= 3000) {
-        uint8_t regBuf[32];
-        if (readRawData(regBuf)) {
-            if (parseBatteryData(regBuf, current_status)) {
-                connected = true;
-                consecutive_failures = 0;
-            } else {
-                connected = false;
-                consecutive_failures++;
+    if (poll_now || current_time - last_read_ms >= pollInterval()) {
+        bool forced = poll_now;
+        poll_now = false;
+        
+        uint32_t start_us = micros();
+        SimpleUPSStatus previous = current_status;
+        bool ok = readRawData();
+        poll_count++;
+        if (ok) {
+            updateFaultFlags(registers.faultFlags());
+            vbus_present = registers.vbus_mV() >= UPS_VBUS_PRESENT_mV;
+            ok = parseBatteryData(registers, current_status);
+        }
+        if (ok) {
+            // Poll fast while the battery is changing, back off while it is steady
+            if (previous.is_connected) {
+                adaptive_interval_ms = adaptPollInterval(previous, current_status, current_time - last_read_ms,
+                                                         adaptive_interval_ms, pollCeiling());
+            }
+            if (forced) {
+                adaptive_interval_ms = UPS_POLL_MIN_MS;
             }
+            
+            UpsPowerSample power;
+            parsePowerRegisters(registers, power);
+            updatePowerModel(power_model, power, current_time - last_read_ms);
+            connected = true;
+            consecutive_failures = 0;
+            #if ENABLE_WATCHDOG
+            saveWarmUpsStatus(current_status);
+            #endif
+            persistStatus();
         } else {
             connected = false;
-            consecutive_failures++;
+            current_status.is_connected = false;
+            if (consecutive_failures < 0xFF) {
+                consecutive_failures++;
+            }
+        }
+        
+        // Worst-case cost of a poll, including timeouts and bus recovery
+        last_poll_us = micros() - start_us;
+        if (last_poll_us > max_poll_us) {
+            max_poll_us = last_poll_us;
         }
+        
         last_read_ms = current_time;
-    }
-    
-    // Update status LED every 50ms for smooth operation
-    if (current_time - last_led_update_ms >= 50) {
+        last_vbus_ms = current_time;
         updateStatusLED();
-        last_led_update_ms = current_time;
+        
+        // Adapter plugged in or removed: report now instead of at the next interval
+        if (forced) {
+            last_report_ms = current_time - reportInterval();
+        }
+        
+        // Every poll refines the power model; publish it for the host's power budget
+        if (ok && current_time - last_power_report_ms >= UPS_POWER_REPORT_MS) {
+            reportPowerStatus();
+            last_power_report_ms = current_time;
+        }
+    } else if (connected && current_time - last_vbus_ms >= UPS_VBUS_POLL_MS) {
+        pollVbus();
+        last_vbus_ms = current_time;
     }
     
+    // Report battery status at dynamic interval
+    if (current_time - last_report_ms >= reportInterval()) {
+        reportBatteryStatus();
+        last_report_ms = current_time;
+    }
+}
+
+uint32_t SimpleUPS::reportInterval() const {
     // Conservative HID reporting to prevent crashes
-    uint32_t reportInterval = 30000; // Default 30 seconds
     if (consecutive_failures > 2) {
-        reportInterval = 60000; // 60 seconds if failures
+        return 60000; // 60 seconds if failures
     } else if (consecutive_failures > 0) {
-        reportInterval = 45000; // 45 seconds if some failures
+        return 45000; // 45 seconds if some failures
+    }
+    return 30000; // Default 30 seconds
+}
+
+uint32_t SimpleUPS::pollInterval() const {
+    if (connected || consecutive_failures == 0) {
+        // A console override takes precedence over the governor's interval
+        if (tunables.upsPollMs) {
+            return tunables.upsPollMs;
+        }
+        uint32_t ceiling = pollCeiling();
+        return adaptive_interval_ms < ceiling ? adaptive_interval_ms : ceiling;
     }
     
-    // Report battery status at dynamic interval
-    if (current_time - last_report_ms >= reportInterval) {
-        reportBatteryStatus();
-        last_report_ms = current_time;
+    // Exponential backoff while the UPS is not responding
+    uint8_t shift = consecutive_failures - 1;
+    if (shift > 5) {
+        shift = 5;
     }
+    uint32_t backoff = (uint32_t)UPS_RETRY_BASE_MS << shift;
+    return backoff < UPS_RETRY_MAX_MS ? backoff : UPS_RETRY_MAX_MS;
 }
 
-bool SimpleUPS::readRawData(uint8_t* regBuf) {
-    if (!ups_library) {
-        return false;
+uint32_t SimpleUPS::pollCeiling() const {
+    // On external power the VBUS poll catches adapter removal, so the full poll can wait longer
+    return vbus_present ? UPS_POLL_MAX_MS : read_interval_ms;
+}
+
+uint32_t SimpleUPS::msUntilNextUpdate() const {
+    if (!initialized) {
+        return 0xFFFFFFFFUL;
     }
     
-    // Read chip data from UPS
-    ups_library->getChipData(regBuf);
+    if (poll_now) {
+        return 0;
+    }
     
-    // Check if we have valid battery voltage data
-    uint8_t vbat_raw = regBuf[CS32_I2C_ADC_VBAT_REG];
-    if (vbat_raw == 0x00) {
-        return false; // No valid battery data
+    uint32_t current_time = millis();
+    uint32_t elapsed_read = current_time - last_read_ms;
+    uint32_t elapsed_report = current_time - last_report_ms;
+    
+    uint32_t poll_interval = pollInterval();
+    uint32_t next_read = elapsed_read >= poll_interval ? 0 : poll_interval - elapsed_read;
+    if (connected) {
+        uint32_t elapsed_vbus = current_time - last_vbus_ms;
+        uint32_t next_vbus = elapsed_vbus >= UPS_VBUS_POLL_MS ? 0 : UPS_VBUS_POLL_MS - elapsed_vbus;
+        if (next_vbus < next_read) {
+            next_read = next_vbus;
+        }
     }
+    uint32_t interval = reportInterval();
+    uint32_t next_report = elapsed_report >= interval ? 0 : interval - elapsed_report;
     
-    return true;
+    return next_read < next_report ? next_read : next_report;
 }
 
-bool SimpleUPS::parseBatteryData(const uint8_t* regBuf, SimpleUPSStatus& status) {
-    // Extract voltage using DFRobot LPUPS register format
-    uint8_t vbat_raw = regBuf[CS32_I2C_ADC_VBAT_REG];
-    status.voltage_mV = 2880 + vbat_raw * 64;
-    if (status.voltage_mV == 2880) {
-        status.voltage_mV = 0; // No battery connected
+bool SimpleUPS::readRawData() {
+    if (!ups_library) {
+        return false;
     }
     
-    // Extract charge current
-    uint8_t ichg_raw = regBuf[CS32_I2C_ADC_ICHG_REG];
-    uint16_t chargeCurrent = ichg_raw * 64;
-    
-    // Extract discharge current
-    uint8_t idchg_raw = regBuf[CS32_I2C_ADC_IDCHG_REG];
-    uint16_t dischargeCurrent = idchg_raw * 256;
-    
-    // Determine if charging or discharging
-    if (chargeCurrent > 0) {
-        status.current_mA = chargeCurrent;
-        status.is_charging = true;
-    } else if (dischargeCurrent > 0) {
-        status.current_mA = dischargeCurrent;
-        status.is_charging = false;
-    } else {
-        status.current_mA = 0;
-        status.is_charging = false;
+    // Read chip data straight into the register map; every transaction is bounded by the Wire timeout
+    if (!ups_library->getChipData(registers)) {
+        #if DEBUG_PRINT_UPS
+        upsDebug.println("UPS: I2C read failed, recovering bus");
+        #endif
+        ups_library->recoverBus();
+        return false;
     }
     
-    // Calculate capacity percentage
-    status.capacity_percent = calculateSoC(status.voltage_mV, 
-                                         status.current_mA > 0 ? status.current_mA : 0,
-                                         status.is_charging ? abs(status.current_mA) : 0);
+    return true;
+}
+
+void SimpleUPS::pollVbus() {
+    // One register instead of the whole block; a failed read is left to the next full poll
+    vbus_poll_count++;
+    if (!ups_library || !ups_library->getVbusData(registers)) {
+        return;
+    }
     
-    // Clamp capacity to valid range
-    if (status.capacity_percent > 100) status.capacity_percent = 100;
-    if (status.capacity_percent < 0) status.capacity_percent = 0;
+    bool present = registers.vbus_mV() >= UPS_VBUS_PRESENT_mV;
+    if (present != vbus_present) {
+        #if DEBUG_PRINT_UPS
+        upsDebug.println(present ? "UPS: Adapter connected" : "UPS: Adapter removed");
+        #endif
+        poll_now = true;
+    }
+}
+
+bool SimpleUPS::parseBatteryData(const CS32RegisterMap& regs, SimpleUPSStatus& status) {
+    if (!parseBatteryRegisters(regs, status)) {
+        return false;
+    }
     
     status.is_connected = true;
     status.last_update_ms = millis();
     
     #if DEBUG_PRINT_UPS
-    Serial.print("UPS Status - Voltage: ");
-    Serial.print(status.voltage_mV);
-    Serial.print(" mV, Current: ");
-    Serial.print(status.current_mA);
-    Serial.print(" mA, Capacity: ");
-    Serial.print(status.capacity_percent);
-    Serial.print("%, Charging: ");
-    Serial.print(status.is_charging ? "Yes" : "No");
-    Serial.print(", Connected: ");
-    Serial.println(status.is_connected ? "Yes" : "No");
+    upsDebug.print("UPS Status - Voltage: ");
+    upsDebug.print(status.voltage_mV);
+    upsDebug.print(" mV, Current: ");
+    upsDebug.print(status.current_mA);
+    upsDebug.print(" mA, Capacity: ");
+    upsDebug.print(status.capacity_percent);
+    upsDebug.print("%, Charging: ");
+    upsDebug.print(status.is_charging ? "Yes" : "No");
+    upsDebug.print(", Connected: ");
+    upsDebug.println(status.is_connected ? "Yes" : "No");
     #endif
     
     return true;
 }
 
-uint16_t SimpleUPS::calculateSoC(uint16_t v_pack_mV, uint16_t dischargeCurrent_mA, uint16_t chargeCurrent_mA) {
-    uint16_t v_cell_mV = v_pack_mV / N_CELLS_PACK;
+// Names of the CS32_FAULT_* bits, in bit order
+static const char faultOtgUvp[] PROGMEM = "otg_uvp";
+static const char faultOtgOvp[] PROGMEM = "otg_ovp";
+static const char faultLatchoff[] PROGMEM = "latchoff";
+static const char faultSysShort[] PROGMEM = "sys_short";
+static const char faultSysovp[] PROGMEM = "sysovp";
+static const char faultAcoc[] PROGMEM = "acoc";
+static const char faultBatoc[] PROGMEM = "batoc";
+static const char faultAcov[] PROGMEM = "acov";
 
-    // Compensate for internal resistance sag
-    uint16_t v_rest_mV = v_cell_mV;
-    
-    // Discharge compensation
-    if(dischargeCurrent_mA > 100){
-      v_rest_mV = v_rest_mV + (dischargeCurrent_mA * R_INTERNAL_mOHM / 1000);
-    }
+static const char* const faultNames[CS32_FAULT_COUNT] PROGMEM = {
+    faultOtgUvp, faultOtgOvp, faultLatchoff, faultSysShort,
+    faultSysovp, faultAcoc, faultBatoc, faultAcov
+};
 
-    // Select proper OCV table
-    const uint16_t *OCV_V = OCV_mV_A8;
-    if (dischargeCurrent_mA > 1200) {
-        OCV_V = OCV_mV_2A;
+static void printFaultList(uint8_t flags) {
+    Serial.print('[');
+    bool first = true;
+    for (uint8_t i = 0; i < CS32_FAULT_COUNT; i++) {
+        if (flags & (1 << i)) {
+            if (!first) {
+                Serial.print(',');
+            }
+            Serial.print('"');
+            Serial.print((const __FlashStringHelper*)pgm_read_ptr(&faultNames[i]));
+            Serial.print('"');
+            first = false;
+        }
     }
+    Serial.print(']');
+}
 
-    uint16_t v0 = pgm_read_word(&OCV_V[0]);
-    uint16_t v_last = pgm_read_word(&OCV_V[N - 1]);
-    if (v_rest_mV <= v0)     return pgm_read_word(&SOC_PCT[0]);
-    if (v_rest_mV >= v_last) return pgm_read_word(&SOC_PCT[N - 1]);
-
-    for (int i = 0; i < N - 1; ++i) {
-        v0 = pgm_read_word(&OCV_V[i]);
-        uint16_t v1 = pgm_read_word(&OCV_V[i + 1]);
-        if (v_rest_mV >= v0 && v_rest_mV <= v1) {
-            float t = (float)(v_rest_mV - v0) / (float)(v1 - v0);
-            uint16_t soc0 = pgm_read_word(&SOC_PCT[i]);
-            uint16_t soc1 = pgm_read_word(&SOC_PCT[i + 1]);
-            return soc0 + (uint16_t)(t * (soc1 - soc0));
-        }
+void SimpleUPS::updateFaultFlags(uint8_t flags) {
+    if (flags == fault_flags) {
+        return;
     }
+    
+    // Fault event: bits that appeared and bits that went away since the last poll
+    Serial.print("{\"ups_fault\":{\"raised\":");
+    printFaultList(flags & ~fault_flags);
+    Serial.print(",\"cleared\":");
+    printFaultList(fault_flags & ~flags);
+    Serial.print(",\"flags\":");
+    Serial.print(flags);
+    Serial.println("}}");
+    
+    fault_flags = flags;
+}
 
-    return pgm_read_word(&SOC_PCT[N - 1]);
+void SimpleUPS::persistStatus() {
+    #if ENABLE_PERSIST_STORE
+    // Only meaningful changes reach the EEPROM; the store throttles further
+    uint16_t capacity = current_status.capacity_percent;
+    uint16_t moved = capacity > persisted_capacity ? capacity - persisted_capacity : persisted_capacity - capacity;
+    if (persisted_capacity != 0xFFFF && moved < UPS_PERSIST_STEP_PERCENT
+        && current_status.is_charging == persisted_charging) {
+        return;
+    }
+    persistSave(PERSIST_KEY_UPS_STATUS, &current_status, sizeof(current_status));
+    persisted_capacity = capacity;
+    persisted_charging = current_status.is_charging;
+    #endif
 }
 
 void SimpleUPS::updateStatusLED() {
-    uint32_t current_time = millis();
-    
+    // Select the pattern; the Timer3 LED engine does the animation
+    uint8_t pattern;
     if (!connected) {
-        // Fast blink when disconnected (500ms cycle)
-        if (current_time - led_cycle_start_ms >= 500) {
-            led_state = !led_state;
-            digitalWrite(UPS_STATUS_LED, led_state);
-            led_cycle_start_ms = current_time;
-        }
-        return;
-    }
-    
-    if (current_status.is_charging) {
-        // Charging: Fading on and off in 5 second rhythm
-        uint32_t cycle_time = (current_time - led_cycle_start_ms) % 5000; // 5 second cycle
-        
-        if (cycle_time < 2500) {
-            // First second: fade in
-            led_brightness = map(cycle_time, 0, 2499, 0, 255);
-        } else {
-            // Second second: fade out
-            led_brightness = map(cycle_time, 2500, 4999, 255, 0);
-        }
-        
-        // Apply brightness using PWM
-        analogWrite(UPS_STATUS_LED, led_brightness);
-        
+        pattern = LED_PATTERN_DISCONNECTED;            // Fast blink when disconnected
+    } else if (led_animation == UPS_LED_ANIM_OFF) {
+        pattern = LED_PATTERN_OFF;
+    } else if (led_animation == UPS_LED_ANIM_MINIMAL) {
+        pattern = LED_PATTERN_FLASH;                   // Short flash once per cycle
+    } else if (current_status.is_charging) {
+        pattern = LED_PATTERN_CHARGING;                // Fading on and off in 5 second rhythm
     } else {
-        // Discharging: Blink On/Off in 2 second window while on time represents remaining percentage
-        uint32_t cycle_time = (current_time - led_cycle_start_ms) % 5000; // 5 second cycle
-        
-        // Calculate on-time based on battery percentage (0-100% maps to 0-5000ms)
-        uint32_t on_time_ms = map(current_status.capacity_percent, 0, 100, 0, 5000);
-        
-        if (cycle_time < on_time_ms) {
-            // LED should be on
-            digitalWrite(UPS_STATUS_LED, HIGH);
-        } else {
-            // LED should be off
-            digitalWrite(UPS_STATUS_LED, LOW);
-        }
+        pattern = (uint8_t)current_status.capacity_percent;  // On-time represents remaining percentage
+    }
+    setStatusLedPattern(pattern);
+}
+
+void SimpleUPS::setLedAnimation(uint8_t animation) {
+    led_animation = animation;
+    if (initialized) {
+        updateStatusLED();
     }
 }
 
@@ -310,7 +424,44 @@ void SimpleUPS::reportBatteryStatus() {
     Serial.print(current_status.is_connected ? "true" : "false");   // Communication with the UPS is established
     Serial.print(",\"last_update_ms\":");
     Serial.print(current_status.last_update_ms);   // Timestamp of last successful update
+    Serial.print(",\"poll_us\":");
+    Serial.print(last_poll_us);   // Duration of the last poll
+    Serial.print(",\"max_poll_us\":");
+    Serial.print(max_poll_us);   // Worst-case poll duration since boot
+    Serial.print(",\"faults\":");
+    Serial.print(fault_flags);   // CS32_FAULT_* bits of the last poll
+    Serial.println("}}");
+}
+
+void SimpleUPS::reportPowerStatus() {
+    // Flat like the status report, so the telemetry daemon parses it the same way
+    const UpsPowerSample& last = power_model.last;
+    Serial.print("{\"ups_power\":{\"in_mW\":");
+    Serial.print(last.input_mW);   // From the adapter
+    Serial.print(",\"sys_mW\":");
+    Serial.print(last.system_mW);   // Drawn by the system
+    Serial.print(",\"bat_mW\":");
+    Serial.print(last.battery_mW);   // Into the battery (negative: out of it)
+    Serial.print(",\"vsys_mV\":");
+    Serial.print(last.vsys_mV);
+    Serial.print(",\"psys_mV\":");
+    Serial.print(last.psys_mV);
+    Serial.print(",\"in_avg_mW\":");
+    Serial.print(power_model.avgInput_mW);   // Running averages (UPS_POWER_AVG_TAU_MS)
+    Serial.print(",\"sys_avg_mW\":");
+    Serial.print(power_model.avgSystem_mW);
+    Serial.print(",\"bat_avg_mW\":");
+    Serial.print(power_model.avgBattery_mW);
+    Serial.print(",\"in_peak_mW\":");
+    Serial.print(power_model.peakInput_mW);   // Peaks since the previous line
+    Serial.print(",\"sys_peak_mW\":");
+    Serial.print(power_model.peakSystem_mW);
+    Serial.print(",\"dischg_peak_mW\":");
+    Serial.print(power_model.peakDischarge_mW);
+    Serial.print(",\"samples\":");
+    Serial.print(power_model.samples);   // Polls in the peak window
     Serial.println("}}");
+    resetPowerPeaks(power_model);
 }
 
 // ============================================================================
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "cs32_registers.h"
 
 // ============================================================================
 // Hardware Configuration
@@ -11,6 +12,17 @@
 #define UPS_STATUS_LED              13      // Status LED pin
 #define UPS_I2C_ADDRESS             0x55    // I2C address for UPS module
 
+// Timing Configuration
+#define UPS_READ_INTERVAL_MS        3000    // Longest battery data poll interval on battery
+#define UPS_POLL_MIN_MS             500     // Poll interval while voltage/current are changing
+#define UPS_POLL_MAX_MS             30000   // Longest poll interval on external power
+#define UPS_VBUS_POLL_MS            1000    // VBUS-only read between polls (adapter plug/removal)
+#define UPS_VBUS_PRESENT_mV         4500    // VBUS at or above this = external power
+#define UPS_POWER_REPORT_MS         2000    // Shortest gap between two power model lines
+#define UPS_PERSIST_STEP_PERCENT    2       // Store the estimate in EEPROM when SoC moved this far
+#define UPS_RETRY_BASE_MS           250     // First retry after a failed poll
+#define UPS_RETRY_MAX_MS            8000    // Retry backoff ceiling
+
 // Battery Configuration
 #define N_CELLS_PACK                3       // 3 cells in series
 #define MIN_CELL_VOLTAGE            2600    // Minimum cell voltage (mV)
@@ -22,6 +34,13 @@
 #define MIN_BATTERY_VOLTAGE         (N_CELLS_PACK * MIN_CELL_VOLTAGE)
 #define MAX_BATTERY_VOLTAGE         (N_CELLS_PACK * MAX_CELL_VOLTAGE)
 
+// Status LED animation level (selected by the performance governor)
+enum UpsLedAnimation : uint8_t {
+    UPS_LED_ANIM_FULL = 0,          // Charging fade, SoC-proportional blink
+    UPS_LED_ANIM_MINIMAL,           // Short flash once per cycle
+    UPS_LED_ANIM_OFF                // LED dark (fault blink only)
+};
+
 // ============================================================================
 // UPS Status Structure
 // ============================================================================
@@ -36,6 +55,27 @@ struct SimpleUPSStatus {
     uint32_t last_update_ms;       // Timestamp of last successful update
 };
 
+// Power flows of one poll and their running figures (ups_battery.h)
+struct UpsPowerSample {
+    uint32_t input_mW;              // From the adapter (0 without external power)
+    uint32_t system_mW;             // Drawn by the deck and the LattePanda
+    int32_t battery_mW;             // Positive while charging, negative while discharging
+    uint16_t vsys_mV;
+    uint16_t psys_mV;               // PSYS pin voltage as measured
+};
+
+struct UpsPowerModel {
+    UpsPowerSample last;
+    uint32_t avgInput_mW;
+    uint32_t avgSystem_mW;
+    int32_t avgBattery_mW;
+    uint32_t peakInput_mW;          // Peaks since resetPowerPeaks()
+    uint32_t peakSystem_mW;
+    uint32_t peakDischarge_mW;
+    uint16_t samples;               // Samples since resetPowerPeaks()
+    bool valid;
+};
+
 // ============================================================================
 // UPS Class
 // ============================================================================
@@ -49,23 +89,47 @@ private:
     bool connected;
     uint32_t last_read_ms;
     uint32_t last_report_ms;
-    uint32_t last_led_update_ms;
     uint8_t consecutive_failures;
+    uint32_t read_interval_ms;      // Poll interval ceiling on battery (governor)
+    uint32_t adaptive_interval_ms;  // Current interval from the battery dynamics
+    uint32_t last_vbus_ms;
+    bool vbus_present;
+    bool poll_now;                  // VBUS changed: poll at the next update()
+    uint32_t poll_count;
+    uint32_t vbus_poll_count;
     
-    // LED control
-    uint32_t led_cycle_start_ms;
-    uint8_t led_brightness;
-    bool led_state;
+    // Poll timing (bounded by LPUPS_I2C_TIMEOUT_US per transaction)
+    uint32_t last_poll_us;
+    uint32_t max_poll_us;
+    
+    // LED control (patterns run in the Timer3 LED engine)
+    uint8_t led_animation;
     
     // Current status
     SimpleUPSStatus current_status;
     
+    // Register block, filled in place by each poll
+    CS32RegisterMap registers;
+    uint8_t fault_flags;            // CS32_FAULT_* bits of the last poll
+    
+    // Input/system/battery power (see ups_battery.h)
+    UpsPowerModel power_model;
+    uint32_t last_power_report_ms;
+    
+    // Estimate last handed to the EEPROM store
+    uint16_t persisted_capacity;
+    bool persisted_charging;
+    
     // Internal methods
-    bool readRawData(uint8_t* regBuf);
-    bool parseBatteryData(const uint8_t* regBuf, SimpleUPSStatus& status);
-    uint16_t calculateSoC(uint16_t v_pack_mV, uint16_t dischargeCurrent_mA, uint16_t chargeCurrent_mA);
+    bool readRawData();
+    void pollVbus();
+    bool parseBatteryData(const CS32RegisterMap& regs, SimpleUPSStatus& status);
+    void updateFaultFlags(uint8_t flags);
     void updateStatusLED();
-    void reportBatteryStatus();
+    void persistStatus();
+    uint32_t reportInterval() const;
+    uint32_t pollInterval() const;
+    uint32_t pollCeiling() const;
     
 public:
     SimpleUPS();
@@ -79,11 +143,32 @@ public:
     // Main update loop (non-blocking)
     void update();
     
+    // Time until update() has work to do again (for idle sleep)
+    uint32_t msUntilNextUpdate() const;
+    
+    // Runtime tuning (performance governor)
+    void setPollInterval(uint32_t interval_ms) { read_interval_ms = interval_ms; }
+    void setLedAnimation(uint8_t animation);
+    
     // Status access
     const SimpleUPSStatus& getStatus() const { return current_status; }
     uint16_t getCapacityPercent() const { return current_status.capacity_percent; }
     uint16_t getVoltage() const { return current_status.voltage_mV; }
     bool isCharging() const { return current_status.is_charging; }
+    uint32_t getLastPollMicros() const { return last_poll_us; }
+    uint32_t getMaxPollMicros() const { return max_poll_us; }
+    uint32_t getPollIntervalMs() const { return pollInterval(); }
+    uint32_t getPollCount() const { return poll_count; }
+    uint32_t getVbusPollCount() const { return vbus_poll_count; }
+    const CS32RegisterMap& getRegisters() const { return registers; }
+    uint8_t getFaultFlags() const { return fault_flags; }
+    const UpsPowerModel& getPowerModel() const { return power_model; }
+    
+    // JSON status report on Serial
+    void reportBatteryStatus();
+    
+    // JSON power model line on Serial; starts a new peak window
+    void reportPowerStatus();
 };
 
 // ============================================================================
@@ -32,6 +32,8 @@
 #define LATTE_REPORT_ID_MOUSE         2
 #define LATTE_REPORT_ID_KEYBOARD      3
 #define LATTE_REPORT_ID_UPS_POWER     1  // UPS Power Device
+#define LATTE_REPORT_ID_HIRES_MOUSE   7  // 16-bit relative mouse (hires_mouse.h)
+#define LATTE_REPORT_ID_NKRO_KEYBOARD 8  // Bitmap keyboard (nkro_keyboard.h)
 
 // HID interface configuration
 // Used for internal reference only - actual USB configuration
@@ -0,0 +1,203 @@
+#include "watchdog.h"
+#include <avr/wdt.h>
+#include <util/crc16.h>
+#include <util/atomic.h>
+
+// ============================================================================
+// Preserved State (.noinit: not cleared by the C runtime on reset)
+// ============================================================================
+
+static WarmState warmState __attribute__((section(".noinit")));
+
+// Written on every feed, so kept outside the CRC; only trusted with a valid warm state
+static volatile uint8_t watchdogStage __attribute__((section(".noinit")));
+static volatile uint8_t watchdogFired __attribute__((section(".noinit")));
+
+#define WATCHDOG_FIRED_MARK         0xA5
+
+// MCUSR as found at reset (cleared by a bootloader that ran first)
+static uint8_t resetFlags __attribute__((section(".noinit")));
+
+static uint8_t resetReason = RESET_REASON_COLD;
+static uint8_t resetStage = WD_STAGE_SETUP;
+
+// After a watchdog reset the watchdog stays enabled at its shortest timeout;
+// turn it off before the C runtime and setup() get a chance to run into it
+void captureResetFlags() __attribute__((naked, used, section(".init3")));
+void captureResetFlags() {
+    resetFlags = MCUSR;
+    MCUSR = 0;
+    wdt_disable();
+}
+
+// ============================================================================
+// Checksum
+// ============================================================================
+
+static uint16_t warmChecksum() {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&warmState);
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < offsetof(WarmState, checksum); i++) {
+        crc = _crc16_update(crc, bytes[i]);
+    }
+    return crc;
+}
+
+// A reset while a field is being written leaves a bad CRC: the next start is cold
+static void sealWarmState() {
+    warmState.checksum = warmChecksum();
+}
+
+// ============================================================================
+// Watchdog
+// ============================================================================
+
+// Last interrupt before the reset: remember that the watchdog caused it
+ISR(WDT_vect) {
+    watchdogFired = WATCHDOG_FIRED_MARK;
+}
+
+#define WATCHDOG_PRESCALER \
+    ((WATCHDOG_TIMEOUT & 0x07) | ((WATCHDOG_TIMEOUT & 0x08) ? _BV(WDP3) : 0))
+#define WATCHDOG_PRESCALER_MASK     (_BV(WDP3) | _BV(WDP2) | _BV(WDP1) | _BV(WDP0))
+
+void startWatchdog() {
+    uint8_t prescaler = WATCHDOG_PRESCALER;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        wdt_reset();
+        // Timed sequence: interrupt first, reset on the following timeout
+        WDTCSR = _BV(WDCE) | _BV(WDE);
+        WDTCSR = _BV(WDIE) | _BV(WDE) | prescaler;
+    }
+}
+
+void feedWatchdog(uint8_t stage) {
+    // A 1200 baud touch makes the core store the bootloader key and arm a 120 ms
+    // watchdog reset (wdt_enable(WDTO_120MS)). Feeding it would keep the sketch
+    // running and the upload would need the reset button, so let it expire.
+    // Opening the port at another rate cancels it (wdt_disable()): start ours again.
+    uint8_t control = WDTCSR;
+    if ((control & WATCHDOG_PRESCALER_MASK) != WATCHDOG_PRESCALER) {
+        if (control & _BV(WDE)) {
+            return;
+        }
+        startWatchdog();
+    }
+
+    wdt_reset();
+    watchdogStage = stage;
+
+    // A stage that ran long but finished: re-arm the interrupt (cleared by hardware
+    // when it fired) so a later hang is still recorded before the reset
+    if (watchdogFired) {
+        watchdogFired = 0;
+        WDTCSR |= _BV(WDIE);
+    }
+}
+
+// ============================================================================
+// Warm State
+// ============================================================================
+
+bool beginWarmState() {
+    bool valid = warmState.magic == WARM_STATE_MAGIC && warmState.checksum == warmChecksum();
+
+    if (!valid) {
+        memset(&warmState, 0, sizeof(warmState));
+        warmState.magic = WARM_STATE_MAGIC;
+        resetReason = RESET_REASON_COLD;
+    } else {
+        bool watchdog = watchdogFired == WATCHDOG_FIRED_MARK || (resetFlags & _BV(WDRF));
+        resetReason = watchdog ? RESET_REASON_WATCHDOG : RESET_REASON_EXTERNAL;
+        resetStage = watchdogStage < WD_STAGE_COUNT ? watchdogStage : (uint8_t)WD_STAGE_SETUP;
+        warmState.resetCount++;
+    }
+
+    watchdogStage = WD_STAGE_SETUP;
+    watchdogFired = 0;
+    sealWarmState();
+    return valid;
+}
+
+bool isWarmRestart() {
+    return resetReason != RESET_REASON_COLD;
+}
+
+uint8_t getResetReason() {
+    return resetReason;
+}
+
+const WarmState& getWarmState() {
+    return warmState;
+}
+
+void saveWarmCalibration(const JoystickData& left, const JoystickData& right) {
+    warmState.joystickZero[0] = left.xZero;
+    warmState.joystickZero[1] = left.yZero;
+    warmState.joystickZero[2] = right.xZero;
+    warmState.joystickZero[3] = right.yZero;
+    warmState.validMask |= WARM_VALID_CALIBRATION;
+    sealWarmState();
+}
+
+bool restoreWarmCalibration(JoystickData& left, JoystickData& right) {
+    if (!isWarmRestart() || !(warmState.validMask & WARM_VALID_CALIBRATION)) {
+        return false;
+    }
+    left.xZero = warmState.joystickZero[0];
+    left.yZero = warmState.joystickZero[1];
+    right.xZero = warmState.joystickZero[2];
+    right.yZero = warmState.joystickZero[3];
+    return true;
+}
+
+void saveWarmProfile(uint8_t profileId) {
+    warmState.perfProfile = profileId;
+    warmState.validMask |= WARM_VALID_PROFILE;
+    sealWarmState();
+}
+
+void saveWarmUpsStatus(const SimpleUPSStatus& status) {
+    warmState.upsStatus = status;
+    warmState.validMask |= WARM_VALID_UPS;
+    sealWarmState();
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+static const char* resetReasonName(uint8_t reason) {
+    switch (reason) {
+        case RESET_REASON_COLD:     return "cold";
+        case RESET_REASON_WATCHDOG: return "watchdog";
+        case RESET_REASON_EXTERNAL: return "external";
+        default:                    return "unknown";
+    }
+}
+
+static const char* watchdogStageName(uint8_t stage) {
+    switch (stage) {
+        case WD_STAGE_SETUP:    return "setup";
+        case WD_STAGE_GAMEPAD:  return "gamepad";
+        case WD_STAGE_CONSOLE:  return "console";
+        case WD_STAGE_UPS:      return "ups";
+        case WD_STAGE_GOVERNOR: return "governor";
+        case WD_STAGE_IDLE:     return "idle";
+        case WD_STAGE_PERSIST:  return "persist";
+        default:                return "unknown";
+    }
+}
+
+void reportResetReason() {
+    // JSON status report, same framing as the UPS report
+    Serial.print("{\"reset\":{\"reason\":\"");
+    Serial.print(resetReasonName(resetReason));
+    Serial.print("\",\"stage\":\"");
+    Serial.print(watchdogStageName(resetStage));
+    Serial.print("\",\"warm_restarts\":");
+    Serial.print(warmState.resetCount);
+    Serial.print(",\"mcusr\":");
+    Serial.print(resetFlags);
+    Serial.println("}}");
+}
@@ -0,0 +1,79 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "gamepad_utils.h"
+#include "ups_simple.h"
+
+// ============================================================================
+// Watchdog and Warm Restart
+// ============================================================================
+// The hardware watchdog is fed once per loop stage. If a stage hangs, the
+// watchdog interrupt records the stage and the following timeout resets the
+// MCU. State that is slow to rebuild (joystick calibration, UPS estimate,
+// performance profile) lives in a .noinit RAM section guarded by a CRC, so
+// after a watchdog or reset-button restart setup() skips the start-up delays
+// and calibration. A power cycle leaves random RAM behind, fails the CRC and
+// starts cold.
+
+#define WATCHDOG_TIMEOUT            WDTO_1S     // Interrupt after this, reset after twice this
+#define WARM_STATE_MAGIC            (0x5700 | sizeof(WarmState))    // Changes with the layout
+
+// Loop stage being run when the watchdog was last fed
+enum WatchdogStage : uint8_t {
+    WD_STAGE_SETUP = 0,
+    WD_STAGE_GAMEPAD,
+    WD_STAGE_CONSOLE,
+    WD_STAGE_UPS,
+    WD_STAGE_GOVERNOR,
+    WD_STAGE_IDLE,
+    WD_STAGE_PERSIST,
+    WD_STAGE_COUNT
+};
+
+enum ResetReason : uint8_t {
+    RESET_REASON_COLD = 0,          // Power-on or invalid warm state
+    RESET_REASON_WATCHDOG,          // Watchdog timeout
+    RESET_REASON_EXTERNAL           // Reset pin, bootloader or brown-out with RAM intact
+};
+
+// Which parts of WarmState hold saved data
+#define WARM_VALID_CALIBRATION      (1 << 0)
+#define WARM_VALID_PROFILE          (1 << 1)
+#define WARM_VALID_UPS              (1 << 2)
+
+struct WarmState {
+    uint16_t magic;
+    uint16_t resetCount;            // Warm restarts since the last cold start
+    uint8_t validMask;              // WARM_VALID_* bits
+    int16_t joystickZero[4];        // Left X/Y, right X/Y
+    uint8_t perfProfile;            // PerfProfileId
+    SimpleUPSStatus upsStatus;      // Last good battery estimate
+    uint16_t checksum;              // CRC-16 of all fields above
+};
+
+// ============================================================================
+// Function Prototypes
+// ============================================================================
+
+// First call in setup(): validates the preserved state, returns true on a warm restart
+bool beginWarmState();
+bool isWarmRestart();
+uint8_t getResetReason();
+const WarmState& getWarmState();
+
+// Enable the watchdog (end of setup) and feed it at the start of every loop stage
+void startWatchdog();
+void feedWatchdog(uint8_t stage);
+
+// Save/restore the preserved state
+void saveWarmCalibration(const JoystickData& left, const JoystickData& right);
+bool restoreWarmCalibration(JoystickData& left, JoystickData& right);
+void saveWarmProfile(uint8_t profileId);
+void saveWarmUpsStatus(const SimpleUPSStatus& status);
+
+// JSON line with the reset reason, the hung stage and the warm restart count
+void reportResetReason();
+
+#endif // WATCHDOG_H